@@ -7,6 +7,8 @@
 
 #include "arena.h"
 
+#include <cerrno>
+#include <chrono>
 #include <stdexcept>
 
 #include "act-iter.h"
@@ -18,6 +20,8 @@
 #include "item-name.h"
 #include "item-status-flag-type.h"
 #include "items.h"
+#include "json.h"
+#include "json-wrapper.h"
 #include "libutil.h"
 #include "los.h"
 #include "macro.h"
@@ -33,6 +37,7 @@
 #include "spl-miscast.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "teleport.h"
 #include "terrain.h"
 #ifdef USE_TILE
@@ -158,6 +163,7 @@ static void _results_popup(string msg, bool error=false)
 namespace arena
 {
     static bool skipped_arena_ui = true; // whether this is an interactive session
+    static bool headless = false; // tournament rounds: no screen, no delays
     static void write_error(const string &error);
 
     struct arena_error : public runtime_error
@@ -219,6 +225,12 @@ namespace arena
 
     static int turns       = 0;
 
+    // Tournament rounds still undecided after this many turns are stopped
+    // and scored as timeouts, so that spawners and respawners can't keep a
+    // worker busy forever.
+    static const int tournament_turn_limit = 10000;
+    static bool timed_out  = false;
+
     static bool allow_summons       = true;
     static bool allow_animate       = true;
     static bool allow_chain_summons = true;
@@ -406,7 +418,8 @@ namespace arena
             env.floor_colour = LIGHTGREY;
 
 #ifdef USE_TILE
-        tile_new_level(true);
+        if (!headless)
+            tile_new_level(true);
 #endif
         los_changed();
         env.markers.activate_all();
@@ -621,6 +634,9 @@ namespace arena
         for (int i = 0; i < NUM_STATS; ++i)
             you.base_stats[i] = 20;
 
+        if (headless)
+            return;
+
         // XXX: now that you.species is valid, do a layout.
         // This is necessary to ensure that the stat window is positioned.
 #ifdef USE_TILE
@@ -867,14 +883,23 @@ namespace arena
 
     static void do_fight()
     {
-        viewwindow();
-        update_screen();
-        clear_messages(true);
+        timed_out = false;
+        if (!headless)
+        {
+            viewwindow();
+            update_screen();
+            clear_messages(true);
+        }
 
         {
             cursor_control coff(false);
             while (fight_is_on() && !contest_cancelled)
             {
+                if (headless && turns >= tournament_turn_limit)
+                {
+                    timed_out = true;
+                    break;
+                }
 #ifdef ARENA_VERBOSE
                 mprf("---- Turn #%d ----", turns);
 #endif
@@ -890,14 +915,23 @@ namespace arena
                 do_respawn(faction_a);
                 do_respawn(faction_b);
                 balance_spawners();
-                ui::delay(Options.view_delay);
-                clear_messages();
+                if (!headless)
+                {
+                    ui::delay(Options.view_delay);
+                    clear_messages();
+                }
                 ASSERT(you.pet_target == MHITNOT);
             }
-            viewwindow();
-            update_screen();
+            if (!headless)
+            {
+                viewwindow();
+                update_screen();
+            }
         }
 
+        if (timed_out)
+            return;
+
         if (contest_cancelled)
         {
             mpr("Cancelled contest at user request");
@@ -960,6 +994,9 @@ namespace arena
         else if (faction_a.won)
             team_a_wins++;
 
+        if (headless)
+            return;
+
         show_fight_banner(true);
 
         string msg;
@@ -999,8 +1036,11 @@ namespace arena
         // Set various options from the arena spec's tags
         parse_monster_spec(); // may throw an arena_error
 
-        crawl_view.init_geometry();
-        expand_mlist(5);
+        if (!headless)
+        {
+            crawl_view.init_geometry();
+            expand_mlist(5);
+        }
 
         for (monster_type i = MONS_0; i < NUM_MONSTERS; ++i)
         {
@@ -1531,6 +1571,311 @@ static void _choose_arena_teams(newgame_def& choice,
         choice.arena_teams = default_arena_teams;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Headless tournaments (-arena-tournament <file>): see docs/arena.txt.
+
+struct tournament_matchup
+{
+    string spec;
+    int rounds;
+    string team_a;
+    string team_b;
+};
+
+static vector<tournament_matchup> _read_tournament(const string &filename)
+{
+    FileLineInput f(filename.c_str());
+    if (f.error())
+    {
+        end(1, false, "Can't read arena tournament %s: %s", filename.c_str(),
+            strerror(errno));
+    }
+
+    vector<tournament_matchup> matchups;
+    int lineno = 0;
+    while (!f.eof())
+    {
+        ++lineno;
+        string line = trimmed_string(f.get_line());
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        tournament_matchup m;
+        m.rounds = 1;
+        const string::size_type bar = line.find('|');
+        if (bar != string::npos)
+        {
+            const string count = trimmed_string(line.substr(0, bar));
+            if (!parse_int(count.c_str(), m.rounds) || m.rounds < 1)
+            {
+                end(1, false, "%s:%d: bad repeat count '%s'",
+                    filename.c_str(), lineno, count.c_str());
+            }
+            line = trimmed_string(line.substr(bar + 1));
+        }
+        m.spec = line;
+
+        try
+        {
+            arena::global_setup(m.spec);
+        }
+        catch (const arena::arena_error &error)
+        {
+            end(1, false, "%s:%d: %s", filename.c_str(), lineno, error.what());
+        }
+        m.team_a = arena::faction_a.desc;
+        m.team_b = arena::faction_b.desc;
+        matchups.push_back(m);
+    }
+    return matchups;
+}
+
+// Fight one round of a matchup, returning "result<TAB>turns<TAB>seconds",
+// where the result is a, b, tie, timeout or an error message.
+static string _tournament_round(const tournament_matchup &m, uint64_t seed)
+{
+    msg::suppress mx;
+    rng::seed(seed);
+
+    const auto start = chrono::steady_clock::now();
+    string result;
+    try
+    {
+        arena::global_setup(m.spec);
+        arena::total_trials = 1;
+        arena::setup_fight();
+        arena::do_fight();
+
+        if (arena::timed_out)
+            result = "timeout";
+        else if (arena::team_a_wins)
+            result = "a";
+        else if (arena::ties)
+            result = "tie";
+        else
+            result = "b";
+    }
+    catch (const arena::arena_error &error)
+    {
+        result = replace_all_of(string("error: ") + error.what(), "\t\n", " ");
+        arena::turns = 0;
+    }
+    const double secs = chrono::duration<double>(chrono::steady_clock::now()
+                                                 - start).count();
+    return make_stringf("%s\t%d\t%.6f", result.c_str(), arena::turns, secs);
+}
+
+// Run every workers'th round, starting with the first'th, into o. Each line
+// is tagged with its round's index so the results can be merged.
+static void _tournament_worker(const vector<tournament_matchup> &matchups,
+                               const vector<int> &round_matchup,
+                               uint64_t base_seed, int first, int workers,
+                               FILE *o)
+{
+    for (size_t i = first; i < round_matchup.size(); i += workers)
+    {
+        const string row = _tournament_round(matchups[round_matchup[i]],
+                                             base_seed + i);
+        fprintf(o, "%u\t%s\n", (unsigned int) i, row.c_str());
+        fflush(o);
+    }
+}
+
+struct tournament_tally
+{
+    int rounds = 0;
+    int a_wins = 0;
+    int b_wins = 0;
+    int ties = 0;
+    int timeouts = 0;
+    int errors = 0;
+    long long turns = 0;
+    int min_turns = INT_MAX;
+    int max_turns = 0;
+    double secs = 0;
+
+    void add(const string &result, int t, double s)
+    {
+        rounds++;
+        if (result == "a")
+            a_wins++;
+        else if (result == "b")
+            b_wins++;
+        else if (result == "tie")
+            ties++;
+        else if (result == "timeout")
+            timeouts++;
+        else
+        {
+            errors++;
+            return;
+        }
+        turns += t;
+        min_turns = min(min_turns, t);
+        max_turns = max(max_turns, t);
+        secs += s;
+    }
+
+    double rate(int n) const
+    {
+        return rounds ? double(n) / rounds : 0.0;
+    }
+
+    double turns_per_second() const
+    {
+        return secs > 0 ? turns / secs : 0.0;
+    }
+};
+
+static JsonNode *_tournament_matchup_json(const tournament_matchup &m,
+                                          const tournament_tally &t,
+                                          const vector<string> &errors)
+{
+    JsonNode *node(json_mkobject());
+    json_append_member(node, "spec", json_mkstring(m.spec.c_str()));
+    json_append_member(node, "team_a", json_mkstring(m.team_a.c_str()));
+    json_append_member(node, "team_b", json_mkstring(m.team_b.c_str()));
+    json_append_member(node, "rounds", json_mknumber(t.rounds));
+    json_append_member(node, "a_wins", json_mknumber(t.a_wins));
+    json_append_member(node, "b_wins", json_mknumber(t.b_wins));
+    json_append_member(node, "ties", json_mknumber(t.ties));
+    json_append_member(node, "timeouts", json_mknumber(t.timeouts));
+    json_append_member(node, "a_win_rate", json_mknumber(t.rate(t.a_wins)));
+    json_append_member(node, "b_win_rate", json_mknumber(t.rate(t.b_wins)));
+
+    const int fought = t.rounds - t.errors;
+    JsonNode *turns(json_mkobject());
+    json_append_member(turns, "total", json_mknumber(t.turns));
+    json_append_member(turns, "mean",
+                       json_mknumber(fought ? double(t.turns) / fought : 0.0));
+    json_append_member(turns, "min", json_mknumber(fought ? t.min_turns : 0));
+    json_append_member(turns, "max", json_mknumber(t.max_turns));
+    json_append_member(node, "turns", turns);
+    json_append_member(node, "seconds", json_mknumber(t.secs));
+
+    if (!errors.empty())
+    {
+        JsonNode *errs(json_mkarray());
+        for (const string &error : errors)
+            json_append_element(errs, json_mkstring(error.c_str()));
+        json_append_member(node, "errors", errs);
+    }
+    return node;
+}
+
+/**
+ * Fight every round of every matchup in a tournament file without a screen,
+ * spread over forked worker processes (one per CPU if workers is 0), and
+ * write the aggregate results to arena-tournament.json.
+ *
+ * Each round gets its own seed (base seed + round index), so results do not
+ * depend on how many workers were used; pass -seed to repeat a run.
+ */
+NORETURN void arena_tournament(const string &filename, int workers)
+{
+    crawl_state.type = GAME_TYPE_ARENA;
+    crawl_state.show_more_prompt = false;
+    arena::headless = true;
+    Options.view_delay = 0;
+    Options.use_animations = UA_NONE;
+    _init_arena();
+#ifdef WIZARD
+    you.wizard = true;
+#endif
+
+    const vector<tournament_matchup> matchups = _read_tournament(filename);
+    vector<int> round_matchup;
+    for (size_t i = 0; i < matchups.size(); ++i)
+        round_matchup.insert(round_matchup.end(), matchups[i].rounds, i);
+    if (round_matchup.empty())
+        end(1, false, "No matchups in %s", filename.c_str());
+
+    const uint64_t base_seed = Options.seed ? Options.seed : rng::get_uint64();
+    const auto start = chrono::steady_clock::now();
+    const vector<vector<string>> rows = run_worker_pool(workers,
+        round_matchup.size(), "arena-tournament",
+        [&](int first, int step, FILE *o)
+        {
+            _tournament_worker(matchups, round_matchup, base_seed, first, step,
+                               o);
+        });
+    const double secs = chrono::duration<double>(chrono::steady_clock::now()
+                                                 - start).count();
+
+    // Tally the rounds by matchup, and by worker for throughput; worker w
+    // fought rounds w, w + workers, ...
+    vector<tournament_tally> by_matchup(matchups.size());
+    vector<vector<string>> errors(matchups.size());
+    vector<tournament_tally> by_worker(workers);
+    tournament_tally total;
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        for (const string &row : rows[i])
+        {
+            const vector<string> fields =
+                split_string("\t", row, false, true);
+            if (fields.size() != 3)
+                continue;
+            const string &result = fields[0];
+            const int t = atoi(fields[1].c_str());
+            const double s = atof(fields[2].c_str());
+            const int m = round_matchup[i];
+            by_matchup[m].add(result, t, s);
+            by_worker[i % workers].add(result, t, s);
+            total.add(result, t, s);
+            if (starts_with(result, "error: "))
+                errors[m].push_back(result.substr(7));
+        }
+    }
+
+    JsonWrapper json(json_mkobject());
+    json_append_member(json.node, "version", json_mkstring(Version::Long));
+    json_append_member(json.node, "seed",
+                       json_mkstring(make_stringf("%" PRIu64, base_seed).c_str()));
+    json_append_member(json.node, "workers", json_mknumber(workers));
+    json_append_member(json.node, "rounds", json_mknumber(total.rounds));
+    json_append_member(json.node, "turns", json_mknumber(total.turns));
+    json_append_member(json.node, "wall_seconds", json_mknumber(secs));
+    json_append_member(json.node, "turns_per_second",
+                       json_mknumber(secs > 0 ? total.turns / secs : 0.0));
+
+    JsonNode *per_worker(json_mkarray());
+    for (const tournament_tally &t : by_worker)
+    {
+        JsonNode *node(json_mkobject());
+        json_append_member(node, "rounds", json_mknumber(t.rounds));
+        json_append_member(node, "turns", json_mknumber(t.turns));
+        json_append_member(node, "seconds", json_mknumber(t.secs));
+        json_append_member(node, "turns_per_second",
+                           json_mknumber(t.turns_per_second()));
+        json_append_element(per_worker, node);
+    }
+    json_append_member(json.node, "per_worker", per_worker);
+
+    JsonNode *results(json_mkarray());
+    for (size_t m = 0; m < matchups.size(); ++m)
+    {
+        json_append_element(results,
+            _tournament_matchup_json(matchups[m], by_matchup[m], errors[m]));
+    }
+    json_append_member(json.node, "matchups", results);
+
+    const char *outfile = "arena-tournament.json";
+    FILE *o = fopen_u(outfile, "w");
+    if (!o)
+        end(1, true, "Can't write %s", outfile);
+    char *text = json_stringify(json.node, "  ");
+    fprintf(o, "%s\n", text ? text : "");
+    free(text);
+    fclose(o);
+
+    printf("arena: %d/%u rounds, %lld turns in %.1fs on %d workers"
+           " (%.0f turns/second); results in %s\n",
+           total.rounds, (unsigned int) round_matchup.size(), total.turns,
+           secs, workers, secs > 0 ? total.turns / secs : 0.0, outfile);
+    end(0, false);
+}
+
 NORETURN void run_arena(const newgame_def& choice, const string &default_arena_teams)
 {
     ASSERT(crawl_state.game_is_arena());
@@ -17,6 +17,8 @@ struct newgame_def;
 
 NORETURN void run_arena(const newgame_def& choice, const string &default_arena_teams);
 
+NORETURN void arena_tournament(const string &filename, int workers);
+
 monster_type arena_pick_random_monster(const level_id &place);
 
 bool arena_veto_random_monster(monster_type type);
@@ -1099,6 +1099,7 @@ void artefact_learn_prop(item_def &item, artefact_prop_type prop)
         return;
 
     known_vec[prop] = static_cast<bool>(true);
+    invalidate_item_names();
 }
 
 static string _get_artefact_type(const item_def &item, bool appear = false)
@@ -0,0 +1,24 @@
+#include "catch.hpp"
+
+#include "AppHdr.h"
+
+#include "clua.h"
+#include "files.h"
+#include "maps.h"
+#include "syscalls.h"
+
+TEST_CASE( "Bundled clua libraries are cached as bytecode", "[single-file]" ) {
+    // The clua builtins are loaded untrusted, as read_init_file() does.
+    const string cache = get_descache_path("clua_kills.lua", ".luc");
+    unlink_u(cache.c_str());
+
+    CLua lua(true);
+    REQUIRE(CLua::loadfile(lua.state(), "clua/kills.lua", false, false) == 0);
+    REQUIRE(file_exists(cache));
+
+    // The second load comes from the cache.
+    lua_pop(lua.state(), 1);
+    REQUIRE(CLua::loadfile(lua.state(), "clua/kills.lua", false, false) == 0);
+
+    unlink_u(cache.c_str());
+}
@@ -4,6 +4,7 @@
 
 #include "artefact.h"
 #include "art-enum.h"
+#include "item-name.h"
 #include "items.h"
 #include "item-prop.h"
 #include "item-prop-enum.h"
@@ -214,3 +215,47 @@ TEST_CASE("Test all_item_subtypes() does include items for each category",
     REQUIRE(all_item_subtypes(OBJ_GOLD).size() > 0);
     REQUIRE(all_item_subtypes(OBJ_RUNES).size() > 0);
 }
+
+TEST_CASE_METHOD( MockPlayerYouTestsFixture,
+                  "Cached item names follow identification and inscriptions",
+                  "[single-file]" ) {
+    item_def scroll_of_fear;
+
+    get_item_by_exact_name(scroll_of_fear, "scroll of fear");
+    set_ident_type(OBJ_SCROLLS, SCR_FEAR, false);
+    move_item_to_inv(scroll_of_fear);
+
+    const int index = find_inv_index_with_exact_item(OBJ_SCROLLS, SCR_FEAR);
+    REQUIRE(index != -1);
+    const item_def &item = you.inv[index];
+
+    const string unknown = item.name(DESC_PLAIN);
+    REQUIRE(unknown.find("fear") == string::npos);
+    REQUIRE(item.name(DESC_PLAIN) == unknown);
+
+    set_ident_type(OBJ_SCROLLS, SCR_FEAR, true);
+    REQUIRE(item.name(DESC_PLAIN) == "scroll of fear");
+
+    you.inv[index].inscription = "flee";
+    REQUIRE(item.name(DESC_PLAIN) == "scroll of fear {flee}");
+    REQUIRE(item.name(DESC_PLAIN, false, false, false) == "scroll of fear");
+}
+
+TEST_CASE_METHOD( MockPlayerYouTestsFixture,
+                  "Cached item names follow prop values", "[single-file]" ) {
+    item_def &corpse = you.inv[ENDOFPACK - 1];
+    corpse.clear();
+    corpse.base_type = OBJ_CORPSES;
+    corpse.sub_type = CORPSE_BODY;
+    corpse.mon_type = MONS_ORC;
+    corpse.quantity = 1;
+    corpse.props[CORPSE_NAME_KEY] = string("Blork");
+    corpse.props[CORPSE_NAME_TYPE_KEY] = int64_t(0);
+    REQUIRE(corpse.name(DESC_PLAIN) == "orc corpse of Blork");
+
+    // Same props, different value.
+    corpse.props[CORPSE_NAME_KEY] = string("Urug");
+    REQUIRE(corpse.name(DESC_PLAIN) == "orc corpse of Urug");
+
+    corpse.clear();
+}
@@ -2,9 +2,13 @@
 
 #include "AppHdr.h"
 
+#include <chrono>
+
 #include "mon-enum.h"
+#include "mon-flags.h"
 #include "monster-type.h"
 #include "mon-util.h"
+#include "stringutil.h"
 
 TEST_CASE("mons_is_removed() returns correct values", "[single-file]")
 {
@@ -103,3 +107,64 @@ TEST_CASE("mons_habitat_type returns correct habitats", "[single-file]")
         REQUIRE(habitat == HT_LAND);
     }
 }
+
+TEST_CASE("class predicates agree with the monster data", "[single-file]")
+{
+    init_monsters();
+
+    for (monster_type mc = MONS_0; mc < NUM_MONSTERS; ++mc)
+    {
+        const monsterentry *me = get_monster_data(mc);
+        REQUIRE(me);
+
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            const auto flag = static_cast<monclass_flag_type>(BIT(bit));
+            REQUIRE(mons_class_flag(mc, flag) == bool(me->bitfields & flag));
+        }
+        REQUIRE(mons_class_holiness(mc) == me->holiness);
+        REQUIRE(mons_class_body_size(mc) == me->size);
+        REQUIRE(mons_class_base_speed(mc) == me->speed);
+        REQUIRE(mons_class_intel(mc) == me->intel);
+    }
+
+    REQUIRE_FALSE(mons_class_flag(NUM_MONSTERS, M_FLIES));
+    REQUIRE(mons_class_body_size(NUM_MONSTERS) == SIZE_MEDIUM);
+}
+
+TEST_CASE("changing a class's holiness updates its predicate", "[single-file]")
+{
+    init_monsters();
+
+    const mon_holy_type orig = mons_class_holiness(MONS_PLAYER_ILLUSION);
+    set_mons_class_holiness(MONS_PLAYER_ILLUSION, MH_UNDEAD);
+    REQUIRE(mons_class_holiness(MONS_PLAYER_ILLUSION) == MH_UNDEAD);
+    REQUIRE(get_monster_data(MONS_PLAYER_ILLUSION)->holiness == MH_UNDEAD);
+
+    set_mons_class_holiness(MONS_PLAYER_ILLUSION, orig);
+    REQUIRE(mons_class_holiness(MONS_PLAYER_ILLUSION) == orig);
+}
+
+// Hidden; run with "./catch2-tests-executable [benchmark]".
+TEST_CASE("class predicate timings", "[.][benchmark]")
+{
+    init_monsters();
+
+    const int passes = 2000;
+    int hits = 0;
+    const auto start = chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+        for (monster_type mc = MONS_0; mc < NUM_MONSTERS; ++mc)
+        {
+            hits += mons_class_flag(mc, M_FLIES);
+            hits += mons_class_is_stationary(mc);
+            hits += bool(mons_class_holiness(mc) & MH_UNDEAD);
+            hits += mons_class_primary_habitat(mc) == HT_WATER;
+        }
+    const double ns = chrono::duration<double, nano>(
+                          chrono::steady_clock::now() - start).count();
+
+    WARN(make_stringf("%.2f ns per predicate (%d hits)",
+                      ns / (4.0 * passes * NUM_MONSTERS), hits));
+    REQUIRE(hits > 0);
+}
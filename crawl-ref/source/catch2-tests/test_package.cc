@@ -0,0 +1,106 @@
+#include "catch.hpp"
+
+#include "AppHdr.h"
+
+#ifdef UNIX
+
+#include <unistd.h>
+
+#include "package.h"
+#include "stringutil.h"
+
+static string _package_test_path()
+{
+    return make_stringf("/tmp/crawl-package-test-%d.cs", (int) getpid());
+}
+
+static void _write_chunk(package &pkg, const string &name, const string &data)
+{
+    chunk_writer *w = pkg.writer(name);
+    w->write(data.data(), data.size());
+    delete w;
+}
+
+static string _read_chunk(package &pkg, const string &name)
+{
+    chunk_reader *r = pkg.reader(name);
+    if (!r)
+        return "";
+    vector<char> buf;
+    r->read_all(buf);
+    delete r;
+    return string(buf.begin(), buf.end());
+}
+
+// What a fresh reader finds on disk, i.e. the last commit.
+static string _committed_chunk(const string &name)
+{
+    package pkg(_package_test_path().c_str(), false);
+    return _read_chunk(pkg, name);
+}
+
+TEST_CASE( "Forked commits leave a consistent save", "[single-file]" ) {
+    package pkg(_package_test_path().c_str(), true, true);
+    _write_chunk(pkg, "you", "you 0");
+    _write_chunk(pkg, "D:1", "level 0");
+    pkg.commit();
+
+    SECTION ("A child's commit is picked up by the parent") {
+        _write_chunk(pkg, "D:2", "level 1");
+        REQUIRE(pkg.fork_commit([&pkg] { _write_chunk(pkg, "you", "you 1"); }));
+
+        // Any use of the package waits for the child first.
+        REQUIRE(_read_chunk(pkg, "you") == "you 1");
+        REQUIRE(_read_chunk(pkg, "D:2") == "level 1");
+        REQUIRE(_committed_chunk("you") == "you 1");
+        REQUIRE(_committed_chunk("D:2") == "level 1");
+
+        // And the parent can carry on writing to the file it reloaded.
+        _write_chunk(pkg, "you", "you 2");
+        pkg.commit();
+        REQUIRE(_committed_chunk("you") == "you 2");
+        REQUIRE(_committed_chunk("D:1") == "level 0");
+    }
+
+    SECTION ("A child that dies before committing changes nothing on disk") {
+        _write_chunk(pkg, "D:2", "level 1");
+        REQUIRE(pkg.fork_commit([&pkg] {
+            _write_chunk(pkg, "you", "you 1");
+            _exit(3);
+        }));
+
+        pkg.await_background();
+        REQUIRE(_committed_chunk("you") == "you 0");
+        REQUIRE(_committed_chunk("D:2") == "");
+
+        // What we wrote before forking is still ours to commit.
+        REQUIRE(_read_chunk(pkg, "D:2") == "level 1");
+        pkg.commit();
+        REQUIRE(_committed_chunk("D:2") == "level 1");
+        REQUIRE(_committed_chunk("you") == "you 0");
+    }
+
+    SECTION ("Every checkpoint on disk is a whole one") {
+        string expected = "you 0";
+        for (int i = 1; i <= 20; ++i)
+        {
+            const string you_data = make_stringf("you %d", i)
+                                    + string(i * 500, 'a' + i % 26);
+            const bool dies = i % 3 == 0;
+            REQUIRE(pkg.fork_commit([&pkg, &you_data, dies] {
+                _write_chunk(pkg, "you", you_data);
+                if (dies)
+                    _exit(3);
+            }));
+            pkg.await_background();
+            if (!dies)
+                expected = you_data;
+            REQUIRE(_committed_chunk("you") == expected);
+            REQUIRE(_committed_chunk("D:1") == "level 0");
+        }
+    }
+
+    pkg.unlink();
+}
+
+#endif
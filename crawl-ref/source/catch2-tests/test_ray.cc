@@ -0,0 +1,71 @@
+#include "catch.hpp"
+
+#include "AppHdr.h"
+
+#include "ray.h"
+
+// The cells met by a ray according to ray_def::advance(), as los.cc used
+// to find them; empty if the ray passes through a bad corner.
+static vector<coord_def> _advance_footprint(ray_def ray, int radius)
+{
+    vector<coord_def> cells;
+    const coord_def origin = ray.pos();
+    while (true)
+    {
+        if (!ray.advance())
+            return vector<coord_def>();
+        const coord_def c = ray.pos() - origin;
+        if (c.rdist() > radius)
+            return cells;
+        cells.push_back(c);
+    }
+}
+
+static void _check_ray(const coord_def &start, int den, const coord_def &dir,
+                       int radius)
+{
+    CAPTURE(start.x, start.y, den, dir.x, dir.y);
+    const ray_def ray(geom::ray((double) start.x / den,
+                                (double) start.y / den, dir.x, dir.y));
+    vector<coord_def> cells;
+    if (!exact_footprint(start, den, dir, radius, cells))
+        cells.clear();
+    REQUIRE(cells == _advance_footprint(ray, radius));
+}
+
+// Every ray cast by los.cc, in every quadrant.
+TEST_CASE("exact_footprint() agrees with ray_def::advance()", "[single-file]")
+{
+    const int max_angle = 2 * LOS_MAX_RANGE - 2;
+    const int radius = 2 * LOS_RADIUS;
+
+    for (int sx = -1; sx <= 1; sx += 2)
+        for (int sy = -1; sy <= 1; sy += 2)
+        {
+            // Mirror the start within its cell along with the direction.
+            auto check = [=](coord_def start, int den, coord_def dir)
+            {
+                if (sx < 0)
+                    start.x = den - start.x;
+                if (sy < 0)
+                    start.y = den - start.y;
+                _check_ray(start, den, coord_def(sx * dir.x, sy * dir.y),
+                           radius);
+            };
+
+            check(coord_def(1, 1), 2, coord_def(0, 1));
+            check(coord_def(1, 1), 2, coord_def(1, 0));
+            for (int xangle = 1; xangle <= max_angle; ++xangle)
+                for (int yangle = 1; yangle <= max_angle; ++yangle)
+                {
+                    const int den = 2 * yangle;
+                    for (int intercept = 1; intercept < den; ++intercept)
+                    {
+                        check(coord_def(intercept, yangle), den,
+                              coord_def(xangle, yangle));
+                        check(coord_def(yangle, intercept), den,
+                              coord_def(yangle, xangle));
+                    }
+                }
+        }
+}
@@ -0,0 +1,79 @@
+#include "catch.hpp"
+
+#include "AppHdr.h"
+
+#include <unistd.h>
+
+#include "replay.h"
+#include "stringutil.h"
+#include "syscalls.h"
+
+static string _replay_test_path(const char *ext)
+{
+    return make_stringf("/tmp/crawl-replay-test-%d.%s", (int) getpid(), ext);
+}
+
+TEST_CASE( "A recorded session replays the same way", "[single-file]" ) {
+    const string rec = _replay_test_path("rec");
+    const string inc = _replay_test_path("rc");
+
+    FILE *f = fopen_u(inc.c_str(), "w");
+    REQUIRE(f);
+    fputs("autofight_stop = 50\nshow_more = false\n", f);
+    fclose(f);
+
+    // Record: the command line, an included file, and keys read after
+    // missed and successful polls and during a timed wait.
+    char arg0[] = "crawl", arg1[] = "-name", arg2[] = "Tester";
+    char *argv[] = { arg0, arg1, arg2, nullptr };
+    replay_record_start(rec, 3, argv);
+    REQUIRE(replay_recording());
+
+    uint64_t recorded[2];
+    REQUIRE(replay_entropy(recorded));
+    replay_record_include("extra.rc", inc);
+
+    replay_note_kbhit(false);
+    replay_note_kbhit(false);
+    replay_note_key('a');
+    replay_note_kbhit(true);
+    replay_note_key('b');
+    {
+        replay_timed_wait wait;
+        replay_note_key('c');
+    }
+    replay_note_key(ESCAPE);
+    replay_record_stop();
+    REQUIRE_FALSE(replay_recording());
+
+    // The included file can change or vanish; the replay has its own copy.
+    unlink_u(inc.c_str());
+
+    replay_load(rec);
+    REQUIRE(replay_playing());
+    REQUIRE(replay_args() == vector<string>({ "-name", "Tester" }));
+
+    uint64_t replayed[2];
+    REQUIRE(replay_entropy(replayed));
+    REQUIRE(replayed[0] == recorded[0]);
+    REQUIRE(replayed[1] == recorded[1]);
+
+    string text;
+    REQUIRE(replay_include("extra.rc", text));
+    REQUIRE(text == "autofight_stop = 50\nshow_more = false\n");
+    REQUIRE_FALSE(replay_include("other.rc", text));
+
+    REQUIRE_FALSE(replay_kbhit());
+    REQUIRE_FALSE(replay_kbhit());
+    REQUIRE(replay_getch() == 'a');
+    REQUIRE(replay_kbhit());
+    REQUIRE(replay_getch() == 'b');
+    {
+        replay_timed_wait wait;
+        REQUIRE(wait.key_due());
+        REQUIRE(replay_getch() == 'c');
+    }
+    REQUIRE(replay_getch() == ESCAPE);
+
+    unlink_u(rec.c_str());
+}
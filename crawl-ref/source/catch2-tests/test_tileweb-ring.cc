@@ -0,0 +1,110 @@
+#include "catch.hpp"
+
+#include "AppHdr.h"
+
+#ifdef USE_TILE_WEB
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "stringutil.h"
+#include "tileweb-ring.h"
+
+static string _ring_test_path()
+{
+    return make_stringf("/tmp/crawl-ring-test-%d.ring", (int) getpid());
+}
+
+TEST_CASE( "Webtiles ring passes messages in order", "[single-file]" ) {
+    webtiles_ring producer;
+    REQUIRE(producer.create(_ring_test_path(), 4096));
+    REQUIRE(producer.capacity() == 4096);
+
+    // The consumer is a second mapping of the same file, as the server's is.
+    webtiles_ring consumer;
+    REQUIRE(consumer.open(_ring_test_path()));
+    REQUIRE(consumer.capacity() == 4096);
+
+    SECTION ("Messages come out as they went in") {
+        string msg;
+        REQUIRE(consumer.empty());
+        REQUIRE_FALSE(consumer.pop(msg));
+
+        REQUIRE(producer.push("{\"msg\":\"one\"}\n", 14));
+        REQUIRE(producer.push("", 0));
+        REQUIRE_FALSE(consumer.empty());
+
+        REQUIRE(consumer.pop(msg));
+        REQUIRE(msg == "{\"msg\":\"one\"}\n");
+        REQUIRE(consumer.pop(msg));
+        REQUIRE(msg == "");
+        REQUIRE_FALSE(consumer.pop(msg));
+    }
+
+    SECTION ("A full ring refuses messages without blocking") {
+        const string big(1500, 'x');
+        REQUIRE(producer.push(big.data(), big.size()));
+        REQUIRE(producer.push(big.data(), big.size()));
+        REQUIRE_FALSE(producer.push(big.data(), big.size()));
+
+        string msg;
+        REQUIRE(consumer.pop(msg));
+        REQUIRE(producer.push(big.data(), big.size()));
+    }
+
+    SECTION ("Records wrap around the end of the data area") {
+        string msg;
+        for (int i = 0; i < 20; ++i)
+        {
+            const string sent = make_stringf("%d:", i) + string(700, 'a' + i);
+            REQUIRE(producer.push(sent.data(), sent.size()));
+            REQUIRE(consumer.pop(msg));
+            REQUIRE(msg == sent);
+        }
+    }
+
+    SECTION ("The waiting flag is handed over once") {
+        REQUIRE_FALSE(producer.take_waiting());
+        consumer.set_waiting();
+        REQUIRE(producer.take_waiting());
+        REQUIRE_FALSE(producer.take_waiting());
+    }
+
+    SECTION ("The file can go once both sides have it mapped") {
+        producer.unlink_file();
+        REQUIRE(access(_ring_test_path().c_str(), F_OK) != 0);
+
+        string msg;
+        REQUIRE(producer.push("after", 5));
+        REQUIRE(consumer.pop(msg));
+        REQUIRE(msg == "after");
+    }
+
+    consumer.close();
+    producer.close();
+    REQUIRE(access(_ring_test_path().c_str(), F_OK) != 0);
+}
+
+TEST_CASE( "Webtiles ring doesn't write through a planted symlink",
+           "[single-file]" ) {
+    const string target = _ring_test_path() + ".target";
+    FILE *f = fopen(target.c_str(), "w");
+    REQUIRE(f);
+    fputs("precious", f);
+    fclose(f);
+    REQUIRE(symlink(target.c_str(), _ring_test_path().c_str()) == 0);
+
+    webtiles_ring producer;
+    REQUIRE(producer.create(_ring_test_path(), 4096));
+
+    struct stat st;
+    REQUIRE(lstat(_ring_test_path().c_str(), &st) == 0);
+    REQUIRE_FALSE(S_ISLNK(st.st_mode));
+    REQUIRE(stat(target.c_str(), &st) == 0);
+    REQUIRE(st.st_size == 8);
+
+    producer.close();
+    unlink(target.c_str());
+}
+
+#endif
@@ -10,12 +10,14 @@
 #include "files.h"
 #include "libutil.h"
 #include "l-libs.h"
+#include "maps.h" // get_descache_path
 #include "maybe-bool.h"
 #include "misc.h" // erase_val
 #include "options.h"
 #include "state.h"
 #include "stringutil.h"
 #include "syscalls.h"
+#include "tags.h"
 #include "unicode.h"
 #include "version.h"
 
@@ -277,6 +279,99 @@ bool CLua::is_path_safe(string s, bool trusted)
            && (trusted || s.find("dlua") != 0);
 }
 
+/////////////////////////////////////////////////////////////////////
+// Bytecode cache for the bundled dlua and clua libraries.
+//
+// These are compiled once and the dumped chunks are kept next to the des
+// cache, with the same header as the des cache files (save version and
+// source mtime) plus the source path. The Lua VM checks the bytecode header
+// itself, so a cache written by an incompatible Lua build just fails to
+// load and is regenerated from source.
+
+// Whether a file is one of the bundled libraries, by where it lives under
+// the data directory. The clua builtins are loaded untrusted, as are user
+// scripts, so the trusted flag can't tell them apart.
+static bool _lua_cacheable(const string &filename)
+{
+    return starts_with(filename, "dlua/") || starts_with(filename, "clua/");
+}
+
+static string _lua_cache_path(const string &filename)
+{
+    // dlua/foo.lua and clua/foo.lua must not share a cache file.
+    return get_descache_path(replace_all(filename, "/", "_"), ".luc");
+}
+
+static bool _load_lua_cache(lua_State *ls, const string &cachefile,
+                            const string &file, time_t mtime)
+{
+    file_lock lock(cachefile + ".lk", "rb", false);
+    FILE *fp = fopen_u(cachefile.c_str(), "rb");
+    if (!fp)
+        return false;
+
+    string compiled;
+    try
+    {
+        reader inf(fp);
+        const auto version = get_save_version(inf);
+        const int64_t t = unmarshallSigned(inf);
+        const string source = unmarshallString(inf);
+        if (version.major != TAG_MAJOR_VERSION
+            || version.minor > TAG_MINOR_VERSION
+            || t != mtime || source != file)
+        {
+            fclose(fp);
+            return false;
+        }
+        unmarshallString4(inf, compiled);
+    }
+    catch (short_read_exception &E)
+    {
+        fclose(fp);
+        return false;
+    }
+    fclose(fp);
+
+    if (luaL_loadbuffer(ls, compiled.c_str(), compiled.length(),
+                        ("@" + file).c_str()))
+    {
+        dprf("Discarding Lua bytecode cache %s: %s", cachefile.c_str(),
+             lua_tostring(ls, -1));
+        lua_pop(ls, 1);
+        return false;
+    }
+    return true;
+}
+
+// Writes the function on top of the stack to the cache. Failures are not
+// fatal; the file will just be compiled from source again next time.
+static void _write_lua_cache(lua_State *ls, const string &cachefile,
+                             const string &file, time_t mtime)
+{
+    string desdir = savedir_versioned_path("des");
+    if (!check_mkdir("Data file cache", &desdir, true))
+        return;
+
+    const dlua_chunk chunk(ls);
+    if (!chunk.error.empty())
+        return;
+
+    file_lock lock(cachefile + ".lk", "wb", false);
+    FILE *fp = fopen_replace(cachefile.c_str());
+    if (!fp)
+        return;
+
+    writer outf(cachefile, fp, true);
+    write_save_version(outf, save_version::current());
+    marshallSigned(outf, mtime);
+    marshallString(outf, file);
+    marshallString4(outf, chunk.compiled_chunk());
+    fclose(fp);
+    if (!outf.succeeded())
+        unlink_u(cachefile.c_str());
+}
+
 int CLua::loadfile(lua_State *ls, const char *filename, bool trusted,
                    bool die_on_fail)
 {
@@ -299,6 +394,12 @@ int CLua::loadfile(lua_State *ls, const char *filename, bool trusted,
         return -1;
     }
 
+    const bool cache = _lua_cacheable(filename);
+    const string cachefile = cache ? _lua_cache_path(filename) : "";
+    const time_t mtime = cache ? file_modtime(file) : 0;
+    if (cache && _load_lua_cache(ls, cachefile, file, mtime))
+        return 0;
+
     FileLineInput f(file.c_str());
     string script;
     while (!f.eof())
@@ -308,8 +409,11 @@ int CLua::loadfile(lua_State *ls, const char *filename, bool trusted,
         abort();
 
     // prefixing with @ stops lua from adding [string "%s"]
-    return luaL_loadbuffer(ls, &script[0], script.length(),
-                           ("@" + file).c_str());
+    const int err = luaL_loadbuffer(ls, &script[0], script.length(),
+                                    ("@" + file).c_str());
+    if (!err && cache)
+        _write_lua_cache(ls, cachefile, file, mtime);
+    return err;
 }
 
 int CLua::execfile(const char *filename, bool trusted, bool die_on_fail,
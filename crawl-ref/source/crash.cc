@@ -80,6 +80,7 @@ template <typename TO, typename FROM> TO nasty_cast(FROM f)
 #   endif
 #endif
 
+#include "errors.h"
 #include "files.h"
 #include "initfile.h"
 #include "options.h"
@@ -102,6 +103,10 @@ void crash_signal_handler(int sig_num);
 
 void crash_signal_handler(int sig_num)
 {
+    // A save child must not write a crash dump over the parent's.
+    if (CrawlIsSaveChild)
+        _exit(1);
+
     // We rely on mutexes ignoring locks held by the same thread.
     // On some platforms, this must be explicitly enabled (which we do).
 
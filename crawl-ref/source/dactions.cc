@@ -258,11 +258,12 @@ void apply_daction_to_mons(monster* mon, daction_type act, bool local,
     }
 }
 
-static void _apply_daction(daction_type act)
+/**
+ * Does this delayed action consist only of a pass over the monsters on the
+ * level, applying apply_daction_to_mons() to each that matches?
+ */
+bool daction_is_per_monster(daction_type act)
 {
-    ASSERT_RANGE(act, 0, NUM_DACTIONS);
-    dprf("applying delayed action: %s", daction_names[act]);
-
     switch (act)
     {
     case DACT_ALLY_YRED_SLAVE:
@@ -276,13 +277,29 @@ static void _apply_daction(daction_type act)
     case DACT_KIRKE_HOGS:
     case DACT_BRIBE_TIMEOUT:
     case DACT_SET_BRIBES:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void _apply_daction(daction_type act)
+{
+    ASSERT_RANGE(act, 0, NUM_DACTIONS);
+    dprf("applying delayed action: %s", daction_names[act]);
+
+    if (daction_is_per_monster(act))
+    {
         for (monster_iterator mi; mi; ++mi)
         {
             if (mons_matches_daction(*mi, act))
                 apply_daction_to_mons(*mi, act, true, false);
         }
-        break;
+        return;
+    }
 
+    switch (act)
+    {
 #if TAG_MAJOR_VERSION == 34
     case DACT_RECLAIM_DECKS:
         reclaim_decks_on_level();
@@ -341,6 +358,18 @@ static void _apply_daction(daction_type act)
     case DACT_ALLY_UNCLEAN_CHAOTIC:
     case DACT_ALLY_SPELLCASTER:
 #endif
+    // Handled above.
+    case DACT_ALLY_YRED_SLAVE:
+    case DACT_ALLY_BEOGH:
+    case DACT_ALLY_HEPLIAKLQANA:
+    case DACT_ALLY_SLIME:
+    case DACT_ALLY_PLANT:
+    case DACT_OLD_CHARMD_SOULS_POOF:
+    case DACT_SLIME_NEW_ATTEMPT:
+    case DACT_PIKEL_MINIONS:
+    case DACT_KIRKE_HOGS:
+    case DACT_BRIBE_TIMEOUT:
+    case DACT_SET_BRIBES:
     case NUM_DACTION_COUNTERS:
     case NUM_DACTIONS:
         ;
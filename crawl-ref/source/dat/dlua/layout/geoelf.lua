@@ -463,44 +463,12 @@ end
 function geoelf.make_glass_doors (e)
   if (geoelf.debug) then print("  geoelf.make_glass_doors") end
 
-  local gxm, gym = dgn.max_bounds()
-  for y = 1, gym - 2 do
-    for x = 1, gxm - 2 do
-      if (e.mapgrd[x][y] == geoelf.glyphs.DOOR) then
-        local south = e.mapgrd[x][y + 1]
-        local north = e.mapgrd[x][y - 1]
-        local east  = e.mapgrd[x + 1][y]
-        local west  = e.mapgrd[x - 1][y]
-        local southeast = e.mapgrd[x + 1][y + 1]
-        local southwest = e.mapgrd[x - 1][y + 1]
-        local northeast = e.mapgrd[x + 1][y - 1]
-        local northwest = e.mapgrd[x - 1][y - 1]
-
-        local any_wall = (south     == geoelf.glyphs.WALL or
-                          north     == geoelf.glyphs.WALL or
-                          east      == geoelf.glyphs.WALL or
-                          west      == geoelf.glyphs.WALL or
-                          southeast == geoelf.glyphs.WALL or
-                          southwest == geoelf.glyphs.WALL or
-                          northeast == geoelf.glyphs.WALL or
-                          northwest == geoelf.glyphs.WALL)
-        local any_glass = (south     == geoelf.glyphs.GLASS or
-                           north     == geoelf.glyphs.GLASS or
-                           east      == geoelf.glyphs.GLASS or
-                           west      == geoelf.glyphs.GLASS or
-                           southeast == geoelf.glyphs.GLASS or
-                           southwest == geoelf.glyphs.GLASS or
-                           northeast == geoelf.glyphs.GLASS or
-                           northwest == geoelf.glyphs.GLASS)
-
-        -- we turn the door into a glass door if it has glass
-        --  around it but no solid walls
-        if (not any_wall and any_glass) then
-          e.mapgrd[x][y] = geoelf.glyphs.GLASS_DOOR
-        end
-      end
-    end
-  end
+  -- we turn the door into a glass door if it has glass
+  --  around it but no solid walls
+  e.replace_by_neighbors { find    = geoelf.glyphs.DOOR,
+                           replace = geoelf.glyphs.GLASS_DOOR,
+                           count   = geoelf.glyphs.GLASS,
+                           forbid  = geoelf.glyphs.WALL }
 end
 
 
@@ -161,14 +161,15 @@ function zonify.map_map(e)
 
 end
 
+-- The map versions are done natively by dgn.fill_small_zones, which walks
+-- the map in the same order as zonify.map does.
 function zonify.map_fill_zones(e, num_to_keep, glyph, min_zone_size)
   if num_to_keep == nil then num_to_keep = 1 end
   if glyph == nil then glyph = 'x' end
   if min_zone_size == nil then min_zone_size = 1 end
 
-  local zonemap = zonify.map_map(e)
-  zonify.fill_smallest_zones(zonemap, num_to_keep, "floor",
-                             function(x,y,cell) e.mapgrd[x][y] = glyph end, min_zone_size)
+  e.fill_small_zones { keep = num_to_keep, fill = glyph,
+                       min_zone_size = min_zone_size, wall = "wlxcvbtg" }
 end
 
 function zonify.map_fill_lava_zones(e, num_to_keep, glyph, min_zone_size)
@@ -176,21 +177,8 @@ function zonify.map_fill_lava_zones(e, num_to_keep, glyph, min_zone_size)
   if glyph == nil then glyph = 'x' end
   if min_zone_size == nil then min_zone_size = 1 end
 
-  local wall = "wxcvbtg"
-
-  -- TODO: Can we check size of current map after extend_map?
-  local gxm,gym = dgn.max_bounds()
-  local zonemap = zonify.map(
-    { x1 = 1, y1 = 1, x2 = gxm-2, y2 = gym-2 },
-    function(x,y)
-      return dgn.in_bounds(x,y) and { glyph = e.mapgrd[x][y] } or nil
-    end,
-    function(val)
-      return string.find(wall,val.glyph,1,true) and "wall" or "floor"
-    end
-  )
-  zonify.fill_smallest_zones(zonemap, num_to_keep, "floor",
-                             function(x,y,cell) e.mapgrd[x][y] = glyph end, min_zone_size)
+  e.fill_small_zones { keep = num_to_keep, fill = glyph,
+                       min_zone_size = min_zone_size, wall = "wxcvbtg" }
 end
 
 -- Zonifies the current dungeon grid
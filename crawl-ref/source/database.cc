@@ -11,6 +11,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unordered_map>
 #if defined(UNIX) || defined(TARGET_COMPILER_MINGW)
 #include <unistd.h>
 #endif
@@ -25,6 +26,39 @@
 #include "syscalls.h"
 #include "unicode.h"
 
+// An in-memory trigram index over the keys and bodies of a database, so
+// that regex searches need only try the entries that contain every literal
+// run the regex requires. ASCII letters are folded to lower case, which
+// suits both case-sensitive and insensitive searches.
+class db_search_index
+{
+public:
+    explicit db_search_index(DBM *database);
+
+    // Indices into keys of the entries that might match regex, or every
+    // entry if the regex requires no literal text we can look up.
+    vector<int> key_candidates(const string &regex) const
+    {
+        return _candidates(key_grams, regex);
+    }
+    vector<int> body_candidates(const string &regex) const
+    {
+        return _candidates(body_grams, regex);
+    }
+
+    vector<string> keys;
+
+private:
+    typedef unordered_map<uint32_t, vector<int>> posting_map;
+
+    void _add(posting_map &grams, int entry, const string &text);
+    vector<int> _candidates(const posting_map &grams,
+                            const string &regex) const;
+
+    posting_map key_grams;
+    posting_map body_grams;
+};
+
 // TextDB handles dependency checking the db vs text files, creating the
 // db, loading, and destroying the DB.
 class TextDB
@@ -43,6 +77,8 @@ public:
     operator bool() const { return _db != 0; }
     operator DBM*() const { return _db; }
 
+    const db_search_index &search_index();
+
  private:
     bool _needs_update() const;
     void _regenerate_db();
@@ -55,6 +91,7 @@ public:
     DBM* _db;
     string timestamp;
     TextDB *_parent;
+    db_search_index *_search_index;
     const char* lang() { return _parent ? Options.lang_name : 0; }
 public:
     TextDB *translation;
@@ -162,7 +199,8 @@ static string _db_cache_path(string db, const char *lang)
 
 TextDB::TextDB(const char* db_name, const char* dir, vector<string> files)
     : _db_name(db_name), _directory(dir), _input_files(files),
-      _db(nullptr), timestamp(""), _parent(0), translation(0)
+      _db(nullptr), timestamp(""), _parent(0), _search_index(nullptr),
+      translation(0)
 {
 }
 
@@ -170,7 +208,8 @@ TextDB::TextDB(TextDB *parent)
     : _db_name(parent->_db_name),
       _directory(parent->_directory + Options.lang_name + "/"),
       _input_files(parent->_input_files), // FIXME: pointless copy
-      _db(nullptr), timestamp(""), _parent(parent), translation(nullptr)
+      _db(nullptr), timestamp(""), _parent(parent), _search_index(nullptr),
+      translation(nullptr)
 {
 }
 
@@ -214,6 +253,8 @@ void TextDB::init()
 
 void TextDB::shutdown(bool recursive)
 {
+    delete _search_index;
+    _search_index = nullptr;
     if (_db)
     {
         dbm_close(_db);
@@ -223,6 +264,14 @@ void TextDB::shutdown(bool recursive)
         translation->shutdown(recursive);
 }
 
+const db_search_index &TextDB::search_index()
+{
+    ASSERT(_db);
+    if (!_search_index)
+        _search_index = new db_search_index(_db);
+    return *_search_index;
+}
+
 bool TextDB::_needs_update() const
 {
     string ts;
@@ -356,7 +405,177 @@ static datum _database_fetch(DBM *database, const string &key)
     return result;
 }
 
-static vector<string> _database_find_keys(DBM *database,
+// ----------------------------------------------------------------------
+// Search index
+// ----------------------------------------------------------------------
+
+static uint32_t _trigram(const char *s)
+{
+    return (uint8_t) toalower(s[0]) << 16
+           | (uint8_t) toalower(s[1]) << 8
+           | (uint8_t) toalower(s[2]);
+}
+
+static bool _ascii_trigram(const char *s)
+{
+    return !(s[0] & 0x80) && !(s[1] & 0x80) && !(s[2] & 0x80);
+}
+
+db_search_index::db_search_index(DBM *database)
+{
+    for (datum dbKey = dbm_firstkey(database); dbKey.dptr != nullptr;
+         dbKey = dbm_nextkey(database))
+    {
+        const int entry = keys.size();
+        keys.emplace_back((const char *)dbKey.dptr, dbKey.dsize);
+        _add(key_grams, entry, keys.back());
+
+        datum dbBody = dbm_fetch(database, dbKey);
+        _add(body_grams, entry, string((const char *)dbBody.dptr,
+                                       dbBody.dsize));
+    }
+}
+
+void db_search_index::_add(posting_map &grams, int entry, const string &text)
+{
+    for (size_t i = 0; i + 3 <= text.size(); i++)
+    {
+        if (!_ascii_trigram(&text[i]))
+            continue;
+        vector<int> &posting = grams[_trigram(&text[i])];
+        // Entries are added in order, so this is enough to keep each
+        // posting list sorted and free of repeats.
+        if (posting.empty() || posting.back() != entry)
+            posting.push_back(entry);
+    }
+}
+
+/**
+ * Find runs of literal text that any match of a regex has to contain.
+ *
+ * This is deliberately simple-minded: anything other than plain characters,
+ * escaped punctuation, '.', anchors, character classes and the ?, * and +
+ * quantifiers makes us give up, as does any alternation or grouping.
+ *
+ * @param regex a PCRE or POSIX extended regex.
+ * @param[out] runs the literal runs found.
+ * @return whether runs can be relied on.
+ */
+static bool _regex_literal_runs(const string &regex, vector<string> &runs)
+{
+    string run;
+    auto end_run = [&]()
+    {
+        if (run.size() >= 3)
+            runs.push_back(run);
+        run.clear();
+    };
+
+    for (size_t i = 0; i < regex.size(); i++)
+    {
+        const char c = regex[i];
+        switch (c)
+        {
+        case '|': case '(': case ')': case '{': case '}':
+            return false;
+        case '?': case '*':
+            // The preceding character (if it was literal) is optional.
+            if (!run.empty())
+                run.pop_back();
+            end_run();
+            break;
+        case '+':
+            end_run();
+            break;
+        case '.': case '^': case '$':
+            end_run();
+            break;
+        case '[':
+        {
+            end_run();
+            size_t j = i + 1;
+            if (j < regex.size() && regex[j] == '^')
+                j++;
+            if (j < regex.size() && regex[j] == ']')
+                j++;
+            while (j < regex.size() && regex[j] != ']')
+            {
+                // Stay away from [:classes:] and escapes inside brackets.
+                if (regex[j] == '[' || regex[j] == '\\')
+                    return false;
+                j++;
+            }
+            if (j >= regex.size())
+                return false;
+            i = j;
+            break;
+        }
+        case '\\':
+            // \w, \b, \x41, \Q...\E and friends are more than we care to
+            // understand; escaped punctuation is just the character.
+            if (i + 1 >= regex.size() || isaalnum(regex[i + 1])
+                || regex[i + 1] & 0x80)
+            {
+                return false;
+            }
+            run += regex[++i];
+            break;
+        default:
+            if (c & 0x80)
+                end_run();
+            else
+                run += c;
+            break;
+        }
+    }
+    end_run();
+    return true;
+}
+
+vector<int> db_search_index::_candidates(const posting_map &grams,
+                                         const string &regex) const
+{
+    vector<string> runs;
+    vector<uint32_t> wanted;
+    if (_regex_literal_runs(regex, runs))
+        for (const string &run : runs)
+            for (size_t i = 0; i + 3 <= run.size(); i++)
+                wanted.push_back(_trigram(&run[i]));
+
+    vector<int> result;
+    if (wanted.empty())
+    {
+        result.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); i++)
+            result[i] = i;
+        return result;
+    }
+
+    vector<const vector<int>*> postings;
+    for (uint32_t gram : wanted)
+    {
+        auto found = grams.find(gram);
+        if (found == grams.end())
+            return result;
+        postings.push_back(&found->second);
+    }
+    sort(postings.begin(), postings.end(),
+         [](const vector<int>* a, const vector<int>* b)
+         { return a->size() < b->size(); });
+
+    result = *postings[0];
+    for (size_t i = 1; i < postings.size() && !result.empty(); i++)
+    {
+        vector<int> both;
+        set_intersection(result.begin(), result.end(),
+                         postings[i]->begin(), postings[i]->end(),
+                         back_inserter(both));
+        result.swap(both);
+    }
+    return result;
+}
+
+static vector<string> _database_find_keys(TextDB &db,
                                           const string &regex,
                                           bool ignore_case,
                                           db_find_filter filter = nullptr)
@@ -364,11 +583,10 @@ static vector<string> _database_find_keys(DBM *database,
     text_pattern             tpat(regex, ignore_case);
     vector<string> matches;
 
-    datum dbKey = dbm_firstkey(database);
-
-    while (dbKey.dptr != nullptr)
+    const db_search_index &index = db.search_index();
+    for (int entry : index.key_candidates(regex))
     {
-        string key((const char *)dbKey.dptr, dbKey.dsize);
+        const string &key = index.keys[entry];
 
         if (tpat.matches(key)
             && key.find("__") == string::npos
@@ -376,14 +594,12 @@ static vector<string> _database_find_keys(DBM *database,
         {
             matches.push_back(key);
         }
-
-        dbKey = dbm_nextkey(database);
     }
 
     return matches;
 }
 
-static vector<string> _database_find_bodies(DBM *database,
+static vector<string> _database_find_bodies(TextDB &db,
                                             const string &regex,
                                             bool ignore_case,
                                             db_find_filter filter = nullptr)
@@ -391,13 +607,12 @@ static vector<string> _database_find_bodies(DBM *database,
     text_pattern             tpat(regex, ignore_case);
     vector<string> matches;
 
-    datum dbKey = dbm_firstkey(database);
-
-    while (dbKey.dptr != nullptr)
+    const db_search_index &index = db.search_index();
+    for (int entry : index.body_candidates(regex))
     {
-        string key((const char *)dbKey.dptr, dbKey.dsize);
+        const string &key = index.keys[entry];
 
-        datum dbBody = dbm_fetch(database, dbKey);
+        datum dbBody = _database_fetch(db.get(), key);
         string body((const char *)dbBody.dptr, dbBody.dsize);
 
         if (tpat.matches(body)
@@ -406,8 +621,6 @@ static vector<string> _database_find_bodies(DBM *database,
         {
             matches.push_back(key);
         }
-
-        dbKey = dbm_nextkey(database);
     }
 
     return matches;
@@ -786,7 +999,7 @@ vector<string> getLongDescKeysByRegex(const string &regex,
 
     // FIXME: need to match regex against translated keys, which can't
     // be done by db only.
-    return _database_find_keys(DescriptionDB.get(), regex, true, filter);
+    return _database_find_keys(DescriptionDB, regex, true, filter);
 }
 
 vector<string> getLongDescBodiesByRegex(const string &regex,
@@ -802,8 +1015,8 @@ vector<string> getLongDescBodiesByRegex(const string &regex,
     // Not good, but otherwise we'd have to check hundreds of keys, with
     // two queries for each.
     // SQL can do this in one go, DBM can't.
-    DBM *database = DescriptionDB.translation ?
-        DescriptionDB.translation->get() : DescriptionDB.get();
+    TextDB &database = DescriptionDB.translation ?
+        *DescriptionDB.translation : DescriptionDB;
     return _database_find_bodies(database, regex, true, filter);
 }
 
@@ -868,7 +1081,7 @@ vector<string> getAllFAQKeys()
         return empty;
     }
 
-    return _database_find_keys(FAQDB.get(), "^q.+", false);
+    return _database_find_keys(FAQDB, "^q.+", false);
 }
 
 string getFAQ_Question(const string &key)
@@ -7,6 +7,9 @@
 
 #include <cerrno>
 #include <csignal>
+#ifdef UNIX
+#include <unistd.h>
+#endif
 
 #include "abyss.h"
 #include "chardump.h"
@@ -18,6 +21,7 @@
 #include "directn.h"
 #include "dlua.h"
 #include "env.h"
+#include "errors.h"
 #include "files.h"
 #include "hiscores.h"
 #include "initfile.h"
@@ -801,6 +805,12 @@ NORETURN static void _BreakStrToDebugger(const char *mesg, bool assert)
 #endif
     fprintf(stderr, "%s\n", mesg);
 
+#ifdef UNIX
+    // Don't dump or abort through the crash handler from a save child.
+    if (CrawlIsSaveChild)
+        _exit(1);
+#endif
+
 #if defined(TARGET_OS_WINDOWS)
     OutputDebugString(mesg);
     if (IsDebuggerPresent())
@@ -7,6 +7,8 @@
 
 #include "dbg-maps.h"
 
+#include <chrono>
+
 #include "branch.h"
 #include "chardump.h"
 #include "crash.h"
@@ -43,9 +45,12 @@ static map<string, string> errors;
 static string last_error;
 
 static int levels_tried = 0, levels_failed = 0;
-static int build_attempts = 0, level_vetoes = 0;
+static int build_attempts = 0, level_vetoes = 0, vault_rollbacks = 0;
 // Map from message to counts.
 static map<string, int> veto_messages;
+static map<string, int> rollback_messages;
+// Wall-clock time spent in builder().
+static chrono::duration<double> build_time;
 
 void mapstat_report_map_build_start()
 {
@@ -60,6 +65,12 @@ void mapstat_report_map_veto(const string &message)
     map_builds[level_id::current()].second++;
 }
 
+void mapstat_report_vault_rollback(const string &message)
+{
+    vault_rollbacks++;
+    ++rollback_messages[message];
+}
+
 static bool _is_disconnected_level()
 {
     // Don't care about non-Dungeon levels.
@@ -93,7 +104,10 @@ static bool _do_build_level()
     }
 
     ++levels_tried;
-    if (!builder())
+    const auto build_start = chrono::steady_clock::now();
+    const bool built = builder();
+    build_time += chrono::steady_clock::now() - build_start;
+    if (!built)
     {
         ++levels_failed;
         // Abort level build failure in objstat since the statistics will be
@@ -341,6 +355,11 @@ static void _write_map_stats()
     fprintf(outf, "Levels attempted: %d, built: %d, failed: %d\n",
             levels_tried, levels_tried - levels_failed,
             levels_failed);
+    fprintf(outf, "Build attempts: %d, vetoes: %d, vault rollbacks: %d\n",
+            build_attempts, level_vetoes, vault_rollbacks);
+    fprintf(outf, "Build time: %.2fs total, %.2fms per level\n",
+            build_time.count(),
+            levels_tried ? build_time.count() * 1000 / levels_tried : 0.0);
     if (!errors.empty())
     {
         fprintf(outf, "\n\nMap errors:\n");
@@ -417,6 +436,17 @@ static void _write_map_stats()
             fprintf(outf, "%3d) %s\n", i->first, i->second.c_str());
     }
 
+    if (vault_rollbacks)
+    {
+        fprintf(outf, "\n\nVault rollback reasons:\n");
+        multimap<int, string> sortedreasons;
+        for (const auto &entry : rollback_messages)
+            sortedreasons.insert(make_pair(entry.second, entry.first));
+
+        for (auto i = sortedreasons.rbegin(); i != sortedreasons.rend(); ++i)
+            fprintf(outf, "%3d) %s\n", i->first, i->second.c_str());
+    }
+
     if (!unused_maps.empty() && !SysEnv.map_gen_range)
     {
         fprintf(outf, "\n\nUnused maps:\n\n");
@@ -14,6 +14,7 @@ void mapstat_report_map_success(const string &map_name);
 void mapstat_report_error(const map_def &map, const string &err);
 void mapstat_report_map_build_start();
 void mapstat_report_map_veto(const string &message);
+void mapstat_report_vault_rollback(const string &message);
 void mapstat_generate_stats();
 bool mapstat_build_levels();
 bool mapstat_find_forced_map();
@@ -8,14 +8,21 @@
 #include "dbg-util.h"
 
 #include "artefact.h"
+#include "clua.h"
 #include "directn.h"
+#include "dlua.h"
 #include "dungeon.h"
+#include "env.h"
 #include "format.h"
+#include "ghost.h"
 #include "item-name.h"
 #include "libutil.h"
 #include "macro.h"
+#include "mapmark.h"
 #include "message.h"
+#include "monster.h"
 #include "options.h"
+#include "player.h"
 #include "religion.h"
 #include "scroller.h"
 #include "shopping.h"
@@ -507,6 +514,168 @@ void debug_list_vacant_keys()
     mpr(message);
 }
 
+// Rough count of the heap memory hanging off the objects below. The node
+// overhead of std::map (colour and three links) is approximate, as is
+// treating every string longer than the small-string buffer as allocated.
+static const size_t MAP_NODE_OVERHEAD = 4 * sizeof(void *);
+
+static size_t _string_heap(const string &s)
+{
+    return s.capacity() > string().capacity() ? s.capacity() + 1 : 0;
+}
+
+static size_t _props_heap(const CrawlHashTable &props);
+static size_t _item_heap(const item_def &item);
+static size_t _monster_heap(const monster &mon);
+
+static size_t _store_heap(const CrawlStoreValue &val)
+{
+    switch (val.get_type())
+    {
+    case SV_STR:
+        return sizeof(string) + _string_heap(val.get_string());
+    case SV_COORD:
+        return sizeof(coord_def);
+    case SV_ITEM:
+        return sizeof(item_def) + _item_heap(val.get_item());
+    case SV_HASH:
+        return sizeof(CrawlHashTable) + _props_heap(val.get_table());
+    case SV_VEC:
+    {
+        const CrawlVector &vec = val.get_vector();
+        size_t bytes = sizeof(CrawlVector)
+                       + vec.size() * sizeof(CrawlStoreValue);
+        for (const CrawlStoreValue &elem : vec)
+            bytes += _store_heap(elem);
+        return bytes;
+    }
+    case SV_LEV_ID:
+        return sizeof(level_id);
+    case SV_LEV_POS:
+        return sizeof(level_pos);
+    case SV_MONST:
+        return sizeof(monster) + _monster_heap(val.get_monster());
+    case SV_LUA:
+        return sizeof(dlua_chunk);
+    default:
+        return 0;
+    }
+}
+
+static size_t _props_heap(const CrawlHashTable &props)
+{
+    size_t bytes = 0;
+    for (const auto &entry : props)
+    {
+        bytes += MAP_NODE_OVERHEAD + sizeof(entry)
+                 + _string_heap(entry.first) + _store_heap(entry.second);
+    }
+    return bytes;
+}
+
+static size_t _item_heap(const item_def &item)
+{
+    return _string_heap(item.inscription) + _props_heap(item.props);
+}
+
+static size_t _monster_heap(const monster &mon)
+{
+    size_t bytes = _string_heap(mon.mname)
+                   + mon.travel_path.capacity() * sizeof(coord_def)
+                   + mon.spells.capacity() * sizeof(mon_spell_slot)
+                   + mon.enchantments.size()
+                     * (MAP_NODE_OVERHEAD
+                        + sizeof(mon_enchant_list::value_type))
+                   + _props_heap(mon.props);
+    if (mon.ghost)
+        bytes += sizeof(ghost_demon) + _string_heap(mon.ghost->name);
+    if (mon.constricting)
+    {
+        bytes += sizeof(*mon.constricting) + mon.constricting->size()
+                 * (MAP_NODE_OVERHEAD
+                    + sizeof(actor::constricting_t::value_type));
+    }
+    return bytes;
+}
+
+static size_t _lua_heap(CLua &vm)
+{
+    lua_State *ls = vm.state();
+    return (size_t) lua_gc(ls, LUA_GCCOUNT, 0) * 1024
+           + lua_gc(ls, LUA_GCCOUNTB, 0);
+}
+
+static size_t _process_resident()
+{
+#ifdef TARGET_OS_LINUX
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    unsigned long pages = 0, resident = 0;
+    const bool ok = fscanf(statm, "%lu %lu", &pages, &resident) == 2;
+    fclose(statm);
+    return ok ? resident * sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+static string _kib(size_t bytes)
+{
+    return make_stringf("%zuK", (bytes + 512) / 1024);
+}
+
+/**
+ * Report how the memory held by the game state breaks down: for each part,
+ * what it always occupies and what it has allocated besides.
+ */
+void debug_memory_report()
+{
+    size_t item_heap = 0;
+    int items_used = 0;
+    for (const item_def &item : env.item)
+    {
+        if (!item.defined())
+            continue;
+        ++items_used;
+        item_heap += _item_heap(item);
+    }
+
+    size_t mons_heap = 0;
+    int mons_used = 0;
+    for (const monster &mon : env.mons)
+    {
+        if (!mon.alive())
+            continue;
+        ++mons_used;
+        mons_heap += _monster_heap(mon);
+    }
+
+    size_t you_heap = _props_heap(you.props);
+    for (const item_def &item : you.inv)
+        you_heap += _item_heap(item);
+
+    const size_t env_fixed = sizeof(env) - sizeof(env.item)
+                             - sizeof(env.mons);
+
+    mpr("Memory use (fixed + allocated):");
+    mprf("  items:    %s + %s (%d of %d slots used, %zu bytes each)",
+         _kib(sizeof(env.item)).c_str(), _kib(item_heap).c_str(),
+         items_used, (int) env.item.size(), sizeof(item_def));
+    mprf("  monsters: %s + %s (%d of %d slots used, %zu bytes each)",
+         _kib(sizeof(env.mons)).c_str(), _kib(mons_heap).c_str(),
+         mons_used, (int) env.mons.size(), sizeof(monster));
+    mprf("  level:    %s + %s (grids and level props; %u markers)",
+         _kib(env_fixed).c_str(), _kib(_props_heap(env.properties)).c_str(),
+         (unsigned int) env.markers.get_all().size());
+    mprf("  player:   %s + %s", _kib(sizeof(you)).c_str(),
+         _kib(you_heap).c_str());
+    mprf("  lua:      dlua %s, clua %s", _kib(_lua_heap(dlua)).c_str(),
+         _kib(_lua_heap(clua)).c_str());
+    if (const size_t rss = _process_resident())
+        mprf("  process:  %s resident", _kib(rss).c_str());
+}
+
 #ifdef DEBUG
 static FILE *debugf = 0;
 
@@ -37,5 +37,6 @@ string debug_mon_str(const monster* mon);
 
 void wizard_toggle_dprf();
 void debug_list_vacant_keys();
+void debug_memory_report();
 
 vector<string> level_vault_names(bool force_all=false);
@@ -497,6 +497,9 @@ direction_chooser::direction_chooser(dist& moves_,
 
     behaviour->just_looking = just_looking;
     behaviour->get_desc_func = args.get_desc_func;
+    // The targeter may have been used before, with the world as it was then.
+    if (hitfunc)
+        hitfunc->clear_preview();
     if (unrestricted)
     {
         needs_path = false;
@@ -1235,13 +1238,15 @@ void direction_chooser::draw_beam(crawl_view_buffer &vbuf)
     // Use the new API if implemented.
     if (hitfunc)
     {
-        if (behaviour->targeted() && !hitfunc->set_aim(target()))
+        const bool targeted = behaviour->targeted();
+        if (targeted && !hitfunc->preview_aim(target()))
             return;
         const los_type los = hitfunc->can_affect_unseen()
                                             ? LOS_NONE : LOS_DEFAULT;
         for (radius_iterator ri(you.pos(), los); ri; ++ri)
         {
-            aff_type aff = hitfunc->is_affected(*ri);
+            aff_type aff = targeted ? hitfunc->preview_affected(*ri)
+                                    : hitfunc->is_affected(*ri);
             if (aff
                 && (!feat_is_solid(env.grid(*ri)) || hitfunc->can_affect_walls()))
             {
@@ -122,6 +122,8 @@ _build_secondary_vault(const map_def *vault,
                        const coord_def &where = coord_def(-1, -1));
 
 static const vault_placement *_build_primary_vault(const map_def *vault);
+static const vault_placement *_try_build_secondary_vault(const map_def *vault);
+static void _dgn_count_zones();
 
 static void _build_postvault_level(vault_placement &place);
 static const vault_placement *
@@ -248,6 +250,191 @@ set<string> &get_uniq_map_names()
         return you.uniq_map_names;
 }
 
+/**
+ * A snapshot of everything placing a secondary vault can change, so that a
+ * vault vetoed after it has been written to the level (failed exit
+ * connections, failed post-place hooks) can be undone without throwing away
+ * the whole level. Used with -vault-rollback.
+ *
+ * Most attempts never find a place for their vault and leave the level
+ * untouched, so the level's contents (items, monsters, grids, markers and so
+ * on) are only copied by take_level(), which _build_vault_impl() calls once
+ * the vault has been placed and before it writes anything. The rest is small
+ * and is copied up front.
+ *
+ * Lua state set up by the vault's own chunks (dgn.persist, globals) is not
+ * restored. Markers are not activated during level generation, so there are
+ * no dungeon event listeners to restore either.
+ */
+class dgn_vault_checkpoint
+{
+public:
+    dgn_vault_checkpoint()
+        : rock_colour(env.rock_colour), floor_colour(env.floor_colour),
+          level_uniq_maps(env.level_uniq_maps),
+          level_uniq_map_tags(env.level_uniq_map_tags),
+          level_layout_types(env.level_layout_types),
+          level_build_method(env.level_build_method),
+          nvaults(env.level_vaults.size()),
+          new_subvault_names(env.new_subvault_names),
+          new_subvault_tags(env.new_subvault_tags),
+          new_used_subvault_names(env.new_used_subvault_names),
+          new_used_subvault_tags(env.new_used_subvault_tags),
+          uniq_map_tags(get_uniq_map_tags()),
+          uniq_map_names(get_uniq_map_names()),
+          unique_creatures(you.unique_creatures),
+          unique_items(you.unique_items),
+          zones(dgn_zones), random_maps(use_random_maps)
+#ifdef DEBUG_STATISTICS
+          , nvault_list(_you_all_vault_list.size())
+#endif
+    {
+    }
+
+    void take_level()
+    {
+        if (!level)
+            level.reset(new level_contents);
+    }
+
+    void restore()
+    {
+        if (level)
+            _restore_level();
+
+        env.rock_colour = rock_colour;
+        env.floor_colour = floor_colour;
+        env.level_uniq_maps = level_uniq_maps;
+        env.level_uniq_map_tags = level_uniq_map_tags;
+        env.level_layout_types = level_layout_types;
+        env.level_build_method = level_build_method;
+        env.level_vaults.resize(nvaults);
+        env.new_subvault_names = new_subvault_names;
+        env.new_subvault_tags = new_subvault_tags;
+        env.new_used_subvault_names = new_used_subvault_names;
+        env.new_used_subvault_tags = new_used_subvault_tags;
+        get_uniq_map_tags() = uniq_map_tags;
+        get_uniq_map_names() = uniq_map_names;
+        you.unique_creatures = unique_creatures;
+        you.unique_items = unique_items;
+        dgn_zones = zones;
+        use_random_maps = random_maps;
+#ifdef DEBUG_STATISTICS
+        _you_all_vault_list.resize(nvault_list);
+#endif
+    }
+
+private:
+    struct level_contents
+    {
+        level_contents()
+            : items(env.item.begin(), env.item.end()),
+              mons(env.mons.begin(), env.mons.end()),
+              grid(env.grid), pgrid(env.pgrid), mgrid(env.mgrid),
+              igrid(env.igrid), grid_colours(env.grid_colours),
+              level_map_mask(env.level_map_mask),
+              level_map_ids(env.level_map_ids),
+              heightmap(env.heightmap ? new grid_heightmap(*env.heightmap)
+                                      : nullptr),
+              cloud(env.cloud), shop(env.shop), trap(env.trap),
+              mons_alloc(env.mons_alloc), markers(env.markers),
+              properties(env.properties), mid_cache(env.mid_cache),
+              flv(tile_env.flv), default_flavour(tile_env.default_flavour),
+              tile_names(tile_env.names)
+        {
+        }
+
+        const vector<item_def> items;
+        const vector<monster> mons;
+        const feature_grid grid;
+        const FixedArray<terrain_property_t, GXM, GYM> pgrid;
+        const FixedArray<unsigned short, GXM, GYM> mgrid;
+        const FixedArray<int, GXM, GYM> igrid;
+        const FixedArray<unsigned short, GXM, GYM> grid_colours;
+        const map_mask level_map_mask, level_map_ids;
+        const unique_ptr<grid_heightmap> heightmap;
+        const map<coord_def, cloud_struct> cloud;
+        const map<coord_def, shop_struct> shop;
+        const map<coord_def, trap_def> trap;
+        const FixedVector<monster_type, MAX_MONS_ALLOC> mons_alloc;
+        const map_markers markers;
+        const CrawlHashTable properties;
+        const map<mid_t, unsigned short> mid_cache;
+        const FixedArray<tile_flavour, GXM, GYM> flv;
+        const tile_flavour default_flavour;
+        const vector<string> tile_names;
+    };
+
+    void _restore_level() const
+    {
+        _keep_new_ghosts();
+
+        for (int i = 0; i < MAX_ITEMS; ++i)
+            env.item[i] = level->items[i];
+        // Monsters first: assigning one takes it off env.mgrid.
+        for (int i = 0; i < MAX_MONSTERS + 2; ++i)
+            env.mons[i] = level->mons[i];
+        env.grid = level->grid;
+        env.pgrid = level->pgrid;
+        env.mgrid = level->mgrid;
+        env.igrid = level->igrid;
+        env.grid_colours = level->grid_colours;
+        env.level_map_mask = level->level_map_mask;
+        env.level_map_ids = level->level_map_ids;
+        env.heightmap.reset(level->heightmap
+                            ? new grid_heightmap(*level->heightmap)
+                            : nullptr);
+        env.cloud = level->cloud;
+        env.shop = level->shop;
+        env.trap = level->trap;
+        env.mons_alloc = level->mons_alloc;
+        env.markers = level->markers;
+        env.properties = level->properties;
+        env.mid_cache = level->mid_cache;
+        tile_env.flv = level->flv;
+        tile_env.default_flavour = level->default_flavour;
+        tile_env.names = level->tile_names;
+    }
+
+    // Ghosts placed by the vault were taken out of the bones file; put them
+    // back rather than losing them, as the level veto handler does.
+    void _keep_new_ghosts() const
+    {
+        vector<ghost_demon> ghosts;
+        for (int i = 0; i < MAX_MONSTERS; ++i)
+        {
+            const monster &mon = env.mons[i];
+            if (mon.alive() && mon.ghost && mons_is_pghost(mon.type)
+                && mon.mid != level->mons[i].mid)
+            {
+                ghosts.push_back(*mon.ghost);
+            }
+        }
+        if (!ghosts.empty())
+            save_ghosts(ghosts, false);
+    }
+
+    unique_ptr<const level_contents> level;
+    const colour_t rock_colour, floor_colour;
+    const string_set level_uniq_maps, level_uniq_map_tags;
+    const string_set level_layout_types;
+    const string level_build_method;
+    const size_t nvaults;
+    const vector<string> new_subvault_names, new_subvault_tags;
+    const string_set new_used_subvault_names, new_used_subvault_tags;
+    const set<string> uniq_map_tags, uniq_map_names;
+    const FixedBitVector<NUM_MONSTERS> unique_creatures;
+    const FixedVector<unique_item_status_type, MAX_UNRANDARTS> unique_items;
+    const int zones;
+    const bool random_maps;
+#ifdef DEBUG_STATISTICS
+    const size_t nvault_list;
+#endif
+};
+
+// The checkpoint of the secondary vault being tried, if any.
+static dgn_vault_checkpoint *vault_checkpoint = nullptr;
+
 /**********************************************************************
  * builder() - kickoff for the dungeon generator.
  *********************************************************************/
@@ -3331,7 +3518,7 @@ static void _place_chance_vaults()
         {
             dprf(DIAG_DNGN, "Placing CHANCE vault: %s (%s)",
                  map->name.c_str(), map->chance(lid).describe().c_str());
-            check_fallback = !_build_secondary_vault(map);
+            check_fallback = !_try_build_secondary_vault(map);
         }
         if (check_fallback)
         {
@@ -3346,7 +3533,7 @@ static void _place_chance_vaults()
                 {
                     dprf(DIAG_DNGN, "Found fallback vault %s for chance tag %s",
                          fallback->name.c_str(), chance_tag.c_str());
-                    _build_secondary_vault(fallback);
+                    _try_build_secondary_vault(fallback);
                 }
             }
         }
@@ -3364,7 +3551,7 @@ static void _place_minivaults()
     }
     // Always try to place PLACE:X minivaults.
     if ((vault = random_map_for_place(level_id::current(), true)))
-        _build_secondary_vault(vault);
+        _try_build_secondary_vault(vault);
 
     if (use_random_maps)
     {
@@ -3373,7 +3560,7 @@ static void _place_minivaults()
         {
             vault = random_map_in_depth(level_id::current(), true);
             if (vault)
-                _build_secondary_vault(vault);
+                _try_build_secondary_vault(vault);
         } // if ALL maps eligible are "extra" but fail to place, we'd be screwed
         while (vault && vault->is_extra_vault() && tries++ < 10000);
     }
@@ -3755,7 +3942,7 @@ static void _place_extra_vaults()
             if (!vault || vault->orient == MAP_ENCOMPASS)
                 break;
 
-            if (_build_secondary_vault(vault))
+            if (_try_build_secondary_vault(vault))
             {
                 const map_def &map(*vault);
                 if (map.is_extra_vault())
@@ -3806,7 +3993,7 @@ static int _place_uniques()
             break;
         }
 
-        const bool map_placed = _build_secondary_vault(uniq_map);
+        const bool map_placed = _try_build_secondary_vault(uniq_map);
         if (map_placed)
         {
             num_placed++;
@@ -4355,11 +4542,9 @@ static const vault_placement *_build_primary_vault(const map_def *vault)
     return _build_vault_impl(vault);
 }
 
-// Builds a vault or minivault. Do not use this function directly: always
-// prefer _build_secondary_vault or _build_primary_vault.
-static const vault_placement *_build_vault_impl(const map_def *vault,
-                  bool build_only, bool check_collisions,
-                  bool make_no_exits, const coord_def &where)
+// Counts the level's disconnected zones the first time a vault is placed
+// with connectivity checking on. Vetoes disconnected Pan levels.
+static void _dgn_count_zones()
 {
     if (dgn_check_connectivity && !dgn_zones)
     {
@@ -4367,6 +4552,44 @@ static const vault_placement *_build_vault_impl(const map_def *vault,
         if (player_in_branch(BRANCH_PANDEMONIUM) && dgn_zones > 1)
             throw dgn_veto_exception("Pan map with disconnected zones");
     }
+}
+
+// Places one of the level's optional secondary vaults (minivaults, extra,
+// chance and unique vaults). With -vault-rollback, a veto raised while
+// placing the vault undoes just that vault, which callers then see as a
+// vault that didn't fit.
+static const vault_placement *_try_build_secondary_vault(const map_def *vault)
+{
+    if (!crawl_state.vault_rollback)
+        return _build_secondary_vault(vault);
+
+    // This can veto the whole level, which no rollback should hide.
+    _dgn_count_zones();
+
+    dgn_vault_checkpoint checkpoint;
+    unwind_var<dgn_vault_checkpoint *> active(vault_checkpoint, &checkpoint);
+    try
+    {
+        return _build_secondary_vault(vault);
+    }
+    catch (dgn_veto_exception &e)
+    {
+        dprf(DIAG_DNGN, "Rolling back %s: %s", vault->name.c_str(), e.what());
+#ifdef DEBUG_STATISTICS
+        mapstat_report_vault_rollback(e.what());
+#endif
+        checkpoint.restore();
+        return nullptr;
+    }
+}
+
+// Builds a vault or minivault. Do not use this function directly: always
+// prefer _build_secondary_vault or _build_primary_vault.
+static const vault_placement *_build_vault_impl(const map_def *vault,
+                  bool build_only, bool check_collisions,
+                  bool make_no_exits, const coord_def &where)
+{
+    _dgn_count_zones();
 
     unwind_var<string> placing(env.placing_vault, vault->name);
 
@@ -4386,6 +4609,9 @@ static const vault_placement *_build_vault_impl(const map_def *vault,
     if (placed_vault_orientation == MAP_NONE)
         return nullptr;
 
+    if (vault_checkpoint)
+        vault_checkpoint->take_level();
+
     const bool is_layout = place.map.is_overwritable_layout();
 
     if (placed_vault_orientation == MAP_ENCOMPASS && !is_layout)
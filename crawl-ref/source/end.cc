@@ -8,6 +8,9 @@
 #include "end.h"
 
 #include <cerrno>
+#ifdef UNIX
+#include <unistd.h>
+#endif
 
 #include "abyss.h"
 #include "chardump.h"
@@ -16,6 +19,7 @@
 #include "database.h"
 #include "describe.h"
 #include "dungeon.h"
+#include "errors.h"
 #include "files.h"
 #include "god-passive.h"
 #include "ghost.h"
@@ -164,9 +168,15 @@ bool fatal_error_notification(string error_msg)
 // free'd memory.
 bool CrawlIsExiting = false;
 bool CrawlIsCrashing = false;
+bool CrawlIsSaveChild = false;
 
 NORETURN void end(int exit_code, bool print_error, const char *format, ...)
 {
+#ifdef UNIX
+    if (CrawlIsSaveChild)
+        _exit(1);
+#endif
+
     disable_other_crashes();
 
     // Let "error" go out of scope for valgrind's sake.
@@ -30,6 +30,10 @@ struct crawl_environment
     colour_t rock_colour;
     colour_t floor_colour;
 
+    // Every slot of these two is held in full, used or not, so each level
+    // costs sizeof(item) + sizeof(mons) whatever it contains (see &^O).
+    // They are not split into compact hot/cold storage: too much code holds
+    // item_def & and monster & across calls, and props live in the slot.
     FixedVector< item_def, MAX_ITEMS >       item;  // item list
     FixedVector< monster, MAX_MONSTERS+2 >   mons;  // monster list, plus anon
 
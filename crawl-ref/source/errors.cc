@@ -10,11 +10,19 @@
 #include <cerrno>
 #include <cstdarg>
 #include <cstring>
+#ifdef UNIX
+#include <unistd.h>
+#endif
 
 #include "stringutil.h"
 
 NORETURN void fail(const char *msg, ...)
 {
+#ifdef UNIX
+    if (CrawlIsSaveChild)
+        _exit(1);
+#endif
+
     va_list args;
     va_start(args, msg);
     string buf = vmake_stringf(msg, args);
@@ -27,6 +35,11 @@ NORETURN void fail(const char *msg, ...)
 
 NORETURN void sysfail(const char *msg, ...)
 {
+#ifdef UNIX
+    if (CrawlIsSaveChild)
+        _exit(1);
+#endif
+
     va_list args;
     va_start(args, msg);
     string buf = vmake_stringf(msg, args);
@@ -27,3 +27,8 @@ struct corrupted_save : public ext_fail_exception
 };
 
 extern bool CrawlIsCrashing;
+
+// Set in the child that package::fork_commit() forks to write a save. It
+// shares the parent's terminal, sockets and exit handlers, so any failure
+// there must leave with _exit() rather than shut the game down.
+extern bool CrawlIsSaveChild;
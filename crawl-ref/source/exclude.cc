@@ -178,12 +178,14 @@ bool travel_exclude::in_bounds(const coord_def &p) const
 
 exclude_set::exclude_set()
 {
+    exclude_counts.init(0);
 }
 
 void exclude_set::clear()
 {
     exclude_roots.clear();
-    exclude_points.clear();
+    exclude_counts.init(0);
+    exclude_mask.reset();
 }
 
 void exclude_set::erase(const coord_def &p)
@@ -193,14 +195,14 @@ void exclude_set::erase(const coord_def &p)
     if (it == exclude_roots.end())
         return;
 
-    travel_exclude old_ex = it->second;
+    remove_exclude_points(it->second);
     exclude_roots.erase(it);
-
-    recompute_excluded_points();
 }
 
 void exclude_set::add_exclude(travel_exclude &ex)
 {
+    if (travel_exclude *old = get_exclude_root(ex.pos))
+        remove_exclude_points(*old);
     add_exclude_points(ex);
     exclude_roots[ex.pos] = ex;
 }
@@ -215,38 +217,56 @@ void exclude_set::add_exclude(const coord_def &p, int radius,
 
 void exclude_set::add_exclude_points(travel_exclude& ex)
 {
+    ex.points.clear();
     if (ex.radius == 0)
+        ex.points.push_back(ex.pos);
+    else
     {
-        exclude_points.insert(ex.pos);
-        return;
+        if (!ex.uptodate)
+            ex.set_los();
+        else
+            ex.los.update();
+
+        for (radius_iterator ri(ex.pos, ex.radius, C_SQUARE); ri; ++ri)
+            if (ex.affects(*ri))
+                ex.points.push_back(*ri);
     }
 
-    if (!ex.uptodate)
-        ex.set_los();
-    else
-        ex.los.update();
+    for (const coord_def &c : ex.points)
+        if (!exclude_counts(c)++)
+            exclude_mask.set(c);
+}
 
-    for (radius_iterator ri(ex.pos, ex.radius, C_SQUARE); ri; ++ri)
-        if (ex.affects(*ri))
-            exclude_points.insert(*ri);
+void exclude_set::remove_exclude_points(travel_exclude& ex)
+{
+    for (const coord_def &c : ex.points)
+    {
+        ASSERT(exclude_counts(c));
+        if (!--exclude_counts(c))
+            exclude_mask.set(c, false);
+    }
+    ex.points.clear();
 }
 
-void exclude_set::update_excluded_points(bool recompute_los)
+// Recompute only the roots whose LOS was invalidated, e.g. by
+// update_exclusion_los() or a radius change.
+void exclude_set::update_excluded_points()
 {
-    for (iterator it = exclude_roots.begin(); it != exclude_roots.end(); ++it)
+    for (auto &entry : exclude_roots)
     {
-        travel_exclude &ex = it->second;
+        travel_exclude &ex = entry.second;
         if (!ex.uptodate)
         {
-            recompute_excluded_points(recompute_los);
-            return;
+            remove_exclude_points(ex);
+            add_exclude_points(ex);
         }
     }
 }
 
 void exclude_set::recompute_excluded_points(bool recompute_los)
 {
-    exclude_points.clear();
+    exclude_counts.init(0);
+    exclude_mask.reset();
     for (iterator it = exclude_roots.begin(); it != exclude_roots.end(); ++it)
     {
         travel_exclude &ex = it->second;
@@ -258,7 +278,7 @@ void exclude_set::recompute_excluded_points(bool recompute_los)
 
 bool exclude_set::is_excluded(const coord_def &p) const
 {
-    return exclude_points.count(p);
+    return map_bounds(p) && exclude_mask(p);
 }
 
 bool exclude_set::is_exclude_root(const coord_def &p) const
@@ -331,7 +351,7 @@ void update_exclusion_los(vector<coord_def> changed)
     for (coord_def c : changed)
         _mark_excludes_non_updated(c);
 
-    curr_excludes.update_excluded_points(true);
+    curr_excludes.update_excluded_points();
 }
 
 bool is_excluded(const coord_def &p, const exclude_set &exc)
@@ -488,7 +508,7 @@ void set_exclude(const coord_def &p, int radius, bool autoexcl, bool vaultexcl,
 
         exc->radius   = radius;
         exc->uptodate = false;
-        curr_excludes.recompute_excluded_points();
+        curr_excludes.update_excluded_points();
     }
     else
     {
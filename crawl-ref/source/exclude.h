@@ -2,6 +2,8 @@
 
 #include <vector>
 
+#include "bitary.h"
+#include "fixedarray.h"
 #include "los-def.h"
 
 using std::vector;
@@ -33,6 +35,7 @@ public:
     bool          autoex;       // Was set automatically.
     string        desc;         // Exclusion description.
     bool          vault;        // Is this exclusion set by a vault?
+    vector<coord_def> points;   // Cells currently counted for this root.
 
     travel_exclude(const coord_def &p, int r = LOS_RADIUS,
                    bool autoex = false, string desc = "",
@@ -68,7 +71,7 @@ public:
                      string desc = "",
                      bool vaultexcl = false);
 
-    void update_excluded_points(bool recompute_los = false);
+    void update_excluded_points();
     void recompute_excluded_points(bool recompute_los = false);
 
     travel_exclude* get_exclude_root(const coord_def &p);
@@ -87,13 +90,17 @@ public:
     iterator  end();
 
 private:
-    typedef set<coord_def> exclset;
-
     exclmap exclude_roots;
-    exclset exclude_points;
+
+    // How many roots cover each cell, and a mask of the cells with any, so
+    // that is_excluded() is a bit test in the travel flood and a root can be
+    // added, dropped or recomputed without touching the others.
+    FixedArray<uint16_t, GXM, GYM> exclude_counts;
+    FixedBitArray<GXM, GYM> exclude_mask;
 
 private:
     void add_exclude_points(travel_exclude& ex);
+    void remove_exclude_points(travel_exclude& ex);
 };
 
 extern exclude_set curr_excludes; // in travel.cc
@@ -1476,6 +1476,9 @@ static void _generic_level_reset()
     // Lose all listeners.
     dungeon_events.clear();
     clear_travel_trail();
+
+    // env.item is about to hold a different level's items.
+    invalidate_item_names();
 }
 
 
@@ -2065,9 +2068,6 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
     if (make_changes || load_mode == LOAD_RESTART_GAME)
         env.markers.activate_all();
 
-    if (make_changes && env.elapsed_time && !just_created_level)
-        update_level(you.elapsed_time - env.elapsed_time);
-
     // Apply all delayed actions, if any. TODO: logic for marshalling this is
     // kind of odd.
     // TODO: does this need make_changes?
@@ -2077,9 +2077,11 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
     // Here's the second cloud clearing, on load (see above).
     if (make_changes)
     {
-        // this includes various things that are irrelevant for new levels, but
+        // Catch up on elapsed time, then on delayed actions. The latter
+        // include various things that are irrelevant for new levels, but
         // also some things that aren't, such as bribe branch.
-        catchup_dactions();
+        catchup_level(env.elapsed_time && !just_created_level
+                      ? you.elapsed_time - env.elapsed_time : 0);
 
         delete_all_clouds();
 
@@ -2110,6 +2112,9 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
         _rescue_player_from_wall();
         // Travel needs initialize some things on reload, too.
         travel_init_load_level();
+        // The level's flavour came with it; just fix up stair markers and
+        // the minimap.
+        tile_new_level(false, false);
     }
 
     _redraw_all();
@@ -2408,6 +2413,15 @@ void save_game(bool leave_game, const char *farewellmsg)
 #endif
     }
 
+    // A checkpoint can be written and committed by a forked child, which
+    // sees the game exactly as it is now, while we carry on.
+    if (!leave_game && Options.background_save
+        && !crawl_state.disables[DIS_SAVE_CHECKPOINTS]
+        && you.save->fork_commit(_save_game_base))
+    {
+        return;
+    }
+
     // Stack allocated string's go in separate function,
     // so Valgrind doesn't complain.
     _save_game_base();
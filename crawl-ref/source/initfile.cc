@@ -41,6 +41,7 @@
 #include "game-options.h"
 #include "ghost.h"
 #include "invent.h"
+#include "item-name.h"
 #include "item-prop.h"
 #include "items.h"
 #include "jobs.h"
@@ -56,6 +57,7 @@
 #include "playable.h"
 #include "player.h"
 #include "prompt.h"
+#include "replay.h"
 #include "slot-select-mode.h"
 #include "species.h"
 #include "spl-util.h"
@@ -150,6 +152,7 @@ const vector<GameOption*> game_options::build_options_list()
         new BoolGameOption(SIMPLE_NAME(easy_door), true),
         new BoolGameOption(SIMPLE_NAME(default_show_all_skills), false),
         new BoolGameOption(SIMPLE_NAME(read_persist_options), false),
+        new BoolGameOption(SIMPLE_NAME(legacy_level_catchup), false),
         new BoolGameOption(SIMPLE_NAME(auto_switch), false),
         new BoolGameOption(SIMPLE_NAME(suppress_startup_errors), false),
         new BoolGameOption(SIMPLE_NAME(simple_targeting), false),
@@ -220,6 +223,7 @@ const vector<GameOption*> game_options::build_options_list()
         new BoolGameOption(SIMPLE_NAME(travel_key_stop), true),
         new BoolGameOption(SIMPLE_NAME(travel_one_unsafe_move), false),
         new BoolGameOption(SIMPLE_NAME(dump_on_save), true),
+        new BoolGameOption(SIMPLE_NAME(background_save), false),
         new BoolGameOption(SIMPLE_NAME(rest_wait_both), false),
         new BoolGameOption(SIMPLE_NAME(rest_wait_ancestor), false),
         new BoolGameOption(SIMPLE_NAME(cloud_status), !is_tiles()),
@@ -282,6 +286,7 @@ const vector<GameOption*> game_options::build_options_list()
         new IntGameOption(SIMPLE_NAME(rest_delay), USING_DGL ? -1 : 0,
                           -1, 2000),
         new IntGameOption(SIMPLE_NAME(explore_delay), -1, -1, 2000),
+        new IntGameOption(SIMPLE_NAME(runrest_redraw_interval), 100, 0, 2000),
         new IntGameOption(SIMPLE_NAME(explore_item_greed), 10, -1000, 1000),
         new IntGameOption(SIMPLE_NAME(explore_wall_bias), 0, 0, 1000),
         new IntGameOption(SIMPLE_NAME(scroll_margin_x), 2, 0),
@@ -1665,11 +1670,17 @@ void read_init_file(bool runscript)
     for (const char *def_file : config_defaults)
         Options.include(datafile_path(def_file), false, runscript);
 
+    // A replay brings its own init file and extra options.
+    string replay_rc;
+    vector<string> extra_first = SysEnv.extra_opts_first;
+    vector<string> extra_last = SysEnv.extra_opts_last;
+    const bool replayed = replay_options(replay_rc, extra_first, extra_last);
+
     // Load early binding extra options from the command line BEFORE init.txt.
     Options.filename     = "extra opts first";
     Options.basefilename = "extra opts first";
     Options.line_num     = 0;
-    for (const string &extra : SysEnv.extra_opts_first)
+    for (const string &extra : extra_first)
     {
         Options.line_num++;
         Options.read_option_line(extra, true);
@@ -1703,6 +1714,9 @@ void read_init_file(bool runscript)
 #endif
 
     FileLineInput f(init_file_name.c_str());
+    StringLineInput replay_f(replay_rc);
+    replay_record_options(init_file_name, SysEnv.extra_opts_first,
+                          SysEnv.extra_opts_last);
 
     Options.filename = init_file_name;
     Options.line_num = 0;
@@ -1712,9 +1726,12 @@ void read_init_file(bool runscript)
     Options.basefilename = "init.txt";
 #endif
 
-    if (f.error())
+    if (replayed)
+        Options.read_options(replay_f, runscript);
+    else if (f.error())
         return;
-    Options.read_options(f, runscript);
+    else
+        Options.read_options(f, runscript);
 
     if (Options.read_persist_options)
     {
@@ -1730,7 +1747,7 @@ void read_init_file(bool runscript)
     Options.filename     = "extra opts last";
     Options.basefilename = "extra opts last";
     Options.line_num     = 0;
-    for (const string &extra : SysEnv.extra_opts_last)
+    for (const string &extra : extra_last)
     {
         Options.line_num++;
         Options.read_option_line(extra, true);
@@ -2066,6 +2083,8 @@ void game_options::read_options(LineInput &il, bool runscript,
 #endif
     }
 
+    // Options such as show_god_gift affect item names.
+    invalidate_item_names();
 }
 
 void game_options::fixup_options()
@@ -3882,8 +3901,13 @@ bool game_options::was_included(const string &file) const
 void game_options::include(const string &rawfilename, bool resolve,
                            bool runscript)
 {
-    const string include_file = resolve ? resolve_include(rawfilename)
-                                        : rawfilename;
+    // A replay reads the files the recording included, not whatever is on
+    // disk now.
+    string replayed;
+    const bool from_replay = resolve && replay_include(rawfilename, replayed);
+    const string include_file = resolve && !from_replay
+                                ? resolve_include(rawfilename)
+                                : rawfilename;
 
     if (was_included(include_file))
         return;
@@ -3900,9 +3924,20 @@ void game_options::include(const string &rawfilename, bool resolve,
     // Also unwind any aliases defined in included files.
     unwind_var<string_map> unwalias(aliases);
 
+    if (from_replay)
+    {
+        StringLineInput sl(replayed);
+        read_options(sl, runscript, false);
+        return;
+    }
+
     FileLineInput fl(include_file.c_str());
     if (!fl.error())
+    {
+        if (resolve)
+            replay_record_include(rawfilename, include_file);
         read_options(fl, runscript, false);
+    }
 }
 
 void game_options::report_error(const char* format, ...)
@@ -3993,7 +4028,11 @@ enum commandline_option_type
     CLO_OBJSTAT,
     CLO_ITERATIONS,
     CLO_FORCE_MAP,
+    CLO_FSIM,
+    CLO_FSIM_WORKERS,
     CLO_ARENA,
+    CLO_ARENA_TOURNAMENT,
+    CLO_ARENA_WORKERS,
     CLO_DUMP_MAPS,
     CLO_TEST,
     CLO_SCRIPT,
@@ -4002,6 +4041,7 @@ enum commandline_option_type
     CLO_VERSION,
     CLO_SEED,
     CLO_PREGEN,
+    CLO_VAULT_ROLLBACK,
     CLO_SAVE_VERSION,
     CLO_SPRINT,
     CLO_EXTRA_OPT_FIRST,
@@ -4022,8 +4062,12 @@ enum commandline_option_type
     CLO_SAVE_JSON,
     CLO_GAMETYPES_JSON,
     CLO_EDIT_BONES,
+    CLO_RECORD,
+    CLO_REPLAY,
+    CLO_HEADLESS,
 #ifdef USE_TILE_WEB
     CLO_WEBTILES_SOCKET,
+    CLO_WEBTILES_SHM,
     CLO_AWAIT_CONNECTION,
     CLO_PRINT_WEBTILES_OPTIONS,
 #endif
@@ -4035,14 +4079,18 @@ static const char *cmd_ops[] =
 {
     "scores", "name", "species", "background", "dir", "rc", "rcdir", "tscores",
     "vscores", "scorefile", "morgue", "macro", "mapstat", "dump-disconnect",
-    "objstat", "iters", "force-map", "arena", "dump-maps", "test", "script",
-    "builddb", "help", "version", "seed", "pregen", "save-version", "sprint",
+    "objstat", "iters", "force-map", "fsim", "fsim-workers", "arena",
+    "arena-tournament", "arena-workers", "dump-maps", "test", "script",
+    "builddb", "help", "version", "seed", "pregen", "vault-rollback",
+    "save-version", "sprint",
     "extra-opt-first", "extra-opt-last", "sprint-map", "edit-save",
     "print-charset", "tutorial", "wizard", "explore", "no-save", "gdb",
     "no-gdb", "nogdb", "throttle", "no-throttle", "playable-json",
-    "branches-json", "save-json", "gametypes-json", "bones",
+    "branches-json", "save-json", "gametypes-json", "bones", "record",
+    "replay", "headless",
 #ifdef USE_TILE_WEB
-    "webtiles-socket", "await-connection", "print-webtiles-options",
+    "webtiles-socket", "webtiles-shm", "await-connection",
+    "print-webtiles-options",
 #endif
 };
 
@@ -4985,6 +5033,27 @@ bool parse_args(int argc, char **argv, bool rc_only)
 #endif
             break;
 
+        case CLO_FSIM:
+#ifdef WIZARD
+            if (!next_is_param)
+                end(1, false, "Matchup file required for -%s\n", arg);
+            crawl_state.fsim_batch = next_arg;
+#ifdef USE_TILE_LOCAL
+            crawl_state.tiles_disabled = true;
+#endif
+            nextUsed = true;
+#else
+            end(1, false, "fsim is available only in WIZARD builds.\n");
+#endif
+            break;
+
+        case CLO_FSIM_WORKERS:
+            if (!next_is_param || !isadigit(*next_arg))
+                end(1, false, "Integer argument required for -%s\n", arg);
+            crawl_state.fsim_workers = atoi(next_arg);
+            nextUsed = true;
+            break;
+
         case CLO_ARENA:
             if (!rc_only)
             {
@@ -4999,6 +5068,23 @@ bool parse_args(int argc, char **argv, bool rc_only)
             }
             break;
 
+        case CLO_ARENA_TOURNAMENT:
+            if (!next_is_param)
+                end(1, false, "Matchup file required for -%s\n", arg);
+            crawl_state.arena_tournament = next_arg;
+#ifdef USE_TILE_LOCAL
+            crawl_state.tiles_disabled = true;
+#endif
+            nextUsed = true;
+            break;
+
+        case CLO_ARENA_WORKERS:
+            if (!next_is_param || !isadigit(*next_arg))
+                end(1, false, "Integer argument required for -%s\n", arg);
+            crawl_state.arena_workers = atoi(next_arg);
+            nextUsed = true;
+            break;
+
         case CLO_DUMP_MAPS:
             crawl_state.dump_maps = true;
             break;
@@ -5172,6 +5258,30 @@ bool parse_args(int argc, char **argv, bool rc_only)
             _edit_bones(argc - current - 1, argv + current + 1);
             end(0);
 
+        case CLO_RECORD:
+            if (!next_is_param)
+                return false;
+#ifdef USE_TILE_LOCAL
+            end(1, false, "-record is only available in console builds.");
+#endif
+            if (rc_only)
+                replay_record_start(next_arg, argc, argv);
+            nextUsed = true;
+            break;
+
+        case CLO_REPLAY:
+            // Handled in main(), which swaps in the recorded command line.
+            if (!next_is_param)
+                return false;
+            nextUsed = true;
+            break;
+
+        case CLO_HEADLESS:
+            if (!replay_playing())
+                end(1, false, "-headless only works with -replay.");
+            replay_set_headless();
+            break;
+
         case CLO_SEED:
             if (!next_is_param)
             {
@@ -5190,6 +5300,10 @@ bool parse_args(int argc, char **argv, bool rc_only)
             Options.pregen_dungeon = true;
             break;
 
+        case CLO_VAULT_ROLLBACK:
+            crawl_state.vault_rollback = true;
+            break;
+
         case CLO_SPRINT:
             if (!rc_only)
                 Options.game.type = GAME_TYPE_SPRINT;
@@ -5234,6 +5348,11 @@ bool parse_args(int argc, char **argv, bool rc_only)
             tiles.m_sock_name = next_arg;
             break;
 
+        case CLO_WEBTILES_SHM:
+            nextUsed          = true;
+            tiles.m_ring_name = next_arg;
+            break;
+
         case CLO_AWAIT_CONNECTION:
             tiles.m_await_connection = true;
             break;
@@ -42,6 +42,11 @@ struct item_def
         short stash_freshness; ///< where stash.cc stores corpse freshness
     };
 #pragma pack(pop)
+    // Fields are ordered to leave no padding: env.item holds MAX_ITEMS of
+    // these whether or not they are in use.
+    uint8_t        rnd;            ///< random number, used for tile choice,
+                                   /// randart colours, and other per-item
+                                   /// random cosmetics. 0 = uninitialized
     union
     {
         // These must all be the same size!
@@ -53,10 +58,8 @@ struct item_def
         int brand;              ///< weapon and armour brands
         int freshness;          ///< remaining time until a corpse rots
     };
-    uint8_t        rnd;            ///< random number, used for tile choice,
-                                   /// randart colours, and other per-item
-                                   /// random cosmetics. 0 = uninitialized
     short          quantity;       ///< number of items
+    short          orig_monnum;
     iflags_t       flags;          ///< item status flags
 
     /// The location of the item. Items in player inventory are indicated by
@@ -75,7 +78,6 @@ struct item_def
     short  slot;
 
     level_id orig_place;
-    short    orig_monnum;
 
     string inscription;
 
@@ -83,9 +85,9 @@ struct item_def
 
 public:
     item_def() : base_type(OBJ_UNASSIGNED), sub_type(0), plus(0), plus2(0),
-                 special(0), rnd(0), quantity(0), flags(0),
+                 rnd(0), special(0), quantity(0), orig_monnum(0), flags(0),
                  pos(), link(NON_ITEM), slot(0), orig_place(),
-                 orig_monnum(0), inscription()
+                 inscription()
     {
     }
 
@@ -149,6 +151,9 @@ public:
     bool is_mundane() const;
 
 private:
+    string name_uncached(description_level_type descrip, bool terse,
+                         bool ident, bool with_inscription,
+                         bool quantity_in_words, iflags_t ignore_flags) const;
     string name_aux(description_level_type desc, bool terse, bool ident,
                     bool with_inscription, iflags_t ignore_flags) const;
 
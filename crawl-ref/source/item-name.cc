@@ -11,6 +11,7 @@
 #include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <unordered_map>
 
 #include "areas.h"
 #include "artefact.h"
@@ -127,6 +128,179 @@ static string _item_inscription(const item_def &item)
                                              ", ").c_str());
 }
 
+// Names of items in the pack and in env.item are cached, keyed on the item's
+// slot and the naming arguments. Anything outside the item itself that feeds
+// into a name (identification, equipment, quiver, options) must call
+// invalidate_item_names() when it changes; the cache is also dropped every
+// turn, so a missed invalidation can't leave a stale name around for long.
+namespace
+{
+    struct item_name_key
+    {
+        const item_def *item;
+        iflags_t ignore_flags;
+        uint8_t descrip;
+        uint8_t opts;
+
+        bool operator==(const item_name_key &other) const
+        {
+            return item == other.item && ignore_flags == other.ignore_flags
+                   && descrip == other.descrip && opts == other.opts;
+        }
+    };
+
+    struct item_name_key_hash
+    {
+        size_t operator()(const item_name_key &key) const
+        {
+            return hash<const item_def *>()(key.item)
+                   ^ (size_t(key.ignore_flags) << 16 | key.descrip << 8
+                      | key.opts);
+        }
+    };
+
+    /// The fields of an item_def that its name is built from.
+    struct item_name_stamp
+    {
+        object_class_type base_type;
+        uint8_t sub_type;
+        short plus;
+        short plus2;
+        int special;
+        uint8_t rnd;
+        short quantity;
+        iflags_t flags;
+        coord_def pos;
+        short link;
+        short orig_monnum;
+        CrawlHashTable props;
+        string inscription;
+
+        explicit item_name_stamp(const item_def &item)
+            : base_type(item.base_type), sub_type(item.sub_type),
+              plus(item.plus), plus2(item.plus2), special(item.special),
+              rnd(item.rnd), quantity(item.quantity), flags(item.flags),
+              pos(item.pos), link(item.link), orig_monnum(item.orig_monnum),
+              props(item.props), inscription(item.inscription)
+        {
+        }
+
+        bool matches(const item_def &item) const;
+    };
+
+    struct item_name_entry
+    {
+        item_name_stamp stamp;
+        string name;
+    };
+}
+
+static unsigned int _item_name_version = 0;
+static unsigned int _item_name_cache_version = 0;
+static unordered_map<item_name_key, item_name_entry, item_name_key_hash>
+    _item_name_cache;
+#ifdef DEBUG_DIAGNOSTICS
+static unsigned int _item_name_hits = 0;
+static unsigned int _item_name_misses = 0;
+#endif
+
+static bool _store_values_equal(const CrawlStoreValue &a,
+                                const CrawlStoreValue &b);
+
+static bool _store_tables_equal(const CrawlHashTable &a,
+                                const CrawlHashTable &b)
+{
+    if (a.size() != b.size())
+        return false;
+    // Both are ordered by key, so they can be walked side by side.
+    for (auto ai = a.begin(), bi = b.begin(); ai != a.end(); ++ai, ++bi)
+    {
+        if (ai->first != bi->first
+            || !_store_values_equal(ai->second, bi->second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _store_values_equal(const CrawlStoreValue &a,
+                                const CrawlStoreValue &b)
+{
+    if (a.get_type() != b.get_type()
+        || (a.get_flags() & SFLAG_UNSET) != (b.get_flags() & SFLAG_UNSET))
+    {
+        return false;
+    }
+    if (a.get_flags() & SFLAG_UNSET)
+        return true;
+
+    switch (a.get_type())
+    {
+    case SV_NONE:     return true;
+    case SV_BOOL:     return a.get_bool() == b.get_bool();
+    case SV_BYTE:     return a.get_byte() == b.get_byte();
+    case SV_SHORT:    return a.get_short() == b.get_short();
+    case SV_INT:      return a.get_int() == b.get_int();
+    case SV_INT64:    return a.get_int64() == b.get_int64();
+    case SV_FLOAT:    return a.get_float() == b.get_float();
+    case SV_STR:      return a.get_string() == b.get_string();
+    case SV_COORD:    return a.get_coord() == b.get_coord();
+    case SV_LEV_ID:   return a.get_level_id() == b.get_level_id();
+    case SV_LEV_POS:  return a.get_level_pos() == b.get_level_pos();
+    case SV_HASH:
+        return _store_tables_equal(a.get_table(), b.get_table());
+    case SV_VEC:
+    {
+        const CrawlVector &av = a.get_vector();
+        const CrawlVector &bv = b.get_vector();
+        if (av.get_type() != bv.get_type() || av.size() != bv.size())
+            return false;
+        for (vec_size i = 0; i < av.size(); ++i)
+            if (!_store_values_equal(av[i], bv[i]))
+                return false;
+        return true;
+    }
+    default:
+        // Items, monsters and lua chunks aren't worth comparing; an item
+        // holding one is just never found in the cache.
+        return false;
+    }
+}
+
+// Props are compared by value: plenty of them (artefact properties and
+// names, known properties, corpse names) change a name without changing
+// how many props there are.
+bool item_name_stamp::matches(const item_def &item) const
+{
+    return base_type == item.base_type && sub_type == item.sub_type
+           && plus == item.plus && plus2 == item.plus2
+           && special == item.special && rnd == item.rnd
+           && quantity == item.quantity && flags == item.flags
+           && pos == item.pos && link == item.link
+           && orig_monnum == item.orig_monnum
+           && inscription == item.inscription
+           && _store_tables_equal(props, item.props);
+}
+
+/**
+ * Discard all cached item names. Call this whenever item knowledge or player
+ * state that shows up in item names changes.
+ */
+void invalidate_item_names()
+{
+    ++_item_name_version;
+}
+
+// Only items with a fixed home are cached: temporary copies on the stack
+// come and go at the same addresses, and would just churn the cache.
+static bool _item_name_cacheable(const item_def &item)
+{
+    const item_def *it = &item;
+    return it >= you.inv.buffer() && it < you.inv.buffer() + ENDOFPACK
+           || it >= env.item.buffer() && it < env.item.buffer() + MAX_ITEMS;
+}
+
 string item_def::name(description_level_type descrip, bool terse, bool ident,
                       bool with_inscription, bool quantity_in_words,
                       iflags_t ignore_flags) const
@@ -137,6 +311,61 @@ string item_def::name(description_level_type descrip, bool terse, bool ident,
     if (descrip == DESC_NONE)
         return "";
 
+    if (!_item_name_cacheable(*this))
+    {
+        return name_uncached(descrip, terse, ident, with_inscription,
+                             quantity_in_words, ignore_flags);
+    }
+
+    if (_item_name_cache_version != _item_name_version)
+    {
+        _item_name_cache.clear();
+        _item_name_cache_version = _item_name_version;
+    }
+
+    const item_name_key key = { this, ignore_flags, (uint8_t) descrip,
+                                (uint8_t) (terse | ident << 1
+                                           | with_inscription << 2
+                                           | quantity_in_words << 3) };
+
+    auto cached = _item_name_cache.find(key);
+    if (cached != _item_name_cache.end() && cached->second.stamp.matches(*this))
+    {
+#ifdef DEBUG_DIAGNOSTICS
+        ++_item_name_hits;
+#endif
+        return cached->second.name;
+    }
+
+#ifdef DEBUG_DIAGNOSTICS
+    if (++_item_name_misses + _item_name_hits >= 10000)
+    {
+        dprf("item name cache: %u hits, %u misses", _item_name_hits,
+             _item_name_misses);
+        _item_name_hits = _item_name_misses = 0;
+    }
+#endif
+
+    const item_name_stamp stamp(*this);
+    string result = name_uncached(descrip, terse, ident, with_inscription,
+                                  quantity_in_words, ignore_flags);
+    // Naming can identify things (and so invalidate the cache) as a side
+    // effect; don't store a name computed under the old knowledge.
+    if (_item_name_cache_version == _item_name_version)
+    {
+        const item_name_entry entry = { stamp, result };
+        auto ins = _item_name_cache.emplace(key, entry);
+        if (!ins.second)
+            ins.first->second = entry;
+    }
+    return result;
+}
+
+string item_def::name_uncached(description_level_type descrip, bool terse,
+                               bool ident, bool with_inscription,
+                               bool quantity_in_words,
+                               iflags_t ignore_flags) const
+{
     ostringstream buff;
 
     const string auxname = name_aux(descrip, terse, ident, with_inscription,
@@ -1985,6 +2214,7 @@ bool set_ident_type(object_class_type basetype, int subtype, bool identify)
 
     you.type_ids[basetype][subtype] = identify;
     request_autoinscribe();
+    invalidate_item_names();
 
     // Our item knowledge changed in a way that could possibly affect shop
     // prices.
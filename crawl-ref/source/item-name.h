@@ -148,6 +148,7 @@ string menu_colour_item_name(const item_def &item,
                                    description_level_type desc);
 
 void            init_item_name_cache();
+void invalidate_item_names();
 item_kind item_kind_by_name(const string &name);
 
 vector<string> item_name_list_for_glyph(char32_t glyph);
@@ -18,6 +18,7 @@
 #include "describe.h"
 #include "god-passive.h"
 #include "invent.h"
+#include "item-name.h"
 #include "items.h"
 #include "item-status-flag-type.h"
 #include "item-use.h"
@@ -951,6 +952,7 @@ void set_ident_flags(item_def &item, iflags_t flags)
     {
         item.flags |= flags;
         request_autoinscribe();
+        invalidate_item_names();
 
         if (in_inventory(item))
         {
@@ -993,6 +995,7 @@ void set_ident_flags(item_def &item, iflags_t flags)
 void unset_ident_flags(item_def &item, iflags_t flags)
 {
     item.flags &= (~flags);
+    invalidate_item_names();
 }
 
 // Returns the mask of interesting identify bits for this item
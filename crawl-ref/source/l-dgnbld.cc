@@ -665,6 +665,153 @@ LUAFN(dgn_fill_disconnected)
     return 0;
 }
 
+/**
+ * Label the zones of a map the way zonify.map() in dlua/layout/zonify.lua
+ * does: walls and floor flood separately (eight-connected), starting at
+ * (1,1) and moving on to each finished zone's borders in turn. Zones are
+ * numbered in the same order the Lua walk creates them, so the two agree
+ * on which of several equally large zones is kept.
+ */
+class map_zone_labeller
+{
+public:
+    struct zone
+    {
+        bool floor;
+        vector<coord_def> cells;
+        vector<coord_def> borders;
+    };
+
+    map_zone_labeller(const map_lines &l, const char *w)
+        : lines(l), wall(w)
+    {
+        label.init(-1);
+    }
+
+    vector<zone> label_map()
+    {
+        _walk(coord_def(1, 1));
+        return move(zones);
+    }
+
+private:
+    bool _is_floor(const coord_def &c) const
+    {
+        return !strchr(wall, lines(c));
+    }
+
+    bool _usable(const coord_def &c) const
+    {
+        return in_bounds(c) && lines.in_bounds(c);
+    }
+
+    // Start a new zone at c and flood it, then start zones on its borders.
+    void _walk(const coord_def &start)
+    {
+        if (!_usable(start) || label(start) != -1)
+            return;
+
+        const int z = zones.size();
+        zones.push_back({ _is_floor(start), { start }, { } });
+        label(start) = z;
+
+        // vector.directions order: the normals, then the diagonals.
+        static const coord_def dirs[] =
+        {
+            { 0, -1 }, { -1, 0 }, { 0, 1 }, { 1, 0 },
+            { -1, -1 }, { -1, 1 }, { 1, 1 }, { 1, -1 },
+        };
+
+        vector<pair<coord_def, int>> stack;
+        stack.emplace_back(start, 0);
+        while (!stack.empty())
+        {
+            auto &top = stack.back();
+            if (top.second == (int) ARRAYSZ(dirs))
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            const coord_def c = top.first + dirs[top.second++];
+            if (!_usable(c) || label(c) != -1)
+                continue;
+
+            if (_is_floor(c) != zones[z].floor)
+                zones[z].borders.push_back(c);
+            else
+            {
+                zones[z].cells.push_back(c);
+                label(c) = z;
+                stack.emplace_back(c, 0);
+            }
+        }
+
+        for (size_t i = 0; i < zones[z].borders.size(); ++i)
+            _walk(zones[z].borders[i]);
+    }
+
+    const map_lines &lines;
+    const char *wall;
+    FixedArray<int, GXM, GYM> label;
+    vector<zone> zones;
+};
+
+// Native version of zonify.map_fill_zones(): fill every floor zone but the
+// largest ones.
+LUAFN(dgn_fill_small_zones)
+{
+    LINES(ls, 1, map, lines);
+
+    TABLE_INT(ls, keep, 1);
+    TABLE_CHAR(ls, fill, 'x');
+    TABLE_INT(ls, min_zone_size, 1);
+    TABLE_STR(ls, wall, "wlxcvbtg");
+
+    if (keep <= 0)
+        return 0;
+
+    const vector<map_zone_labeller::zone> zones
+        = map_zone_labeller(lines, wall).label_map();
+
+    // The largest zones, biggest first, as zonify.fill_smallest_zones keeps
+    // them.
+    vector<int> largest(keep, -1);
+    vector<int> largest_size(keep, -999999);
+    for (int z = 0; z < (int) zones.size(); ++z)
+    {
+        if (!zones[z].floor)
+            continue;
+
+        const int zsize = zones[z].cells.size();
+        for (int n = keep - 1; n >= 0; --n)
+        {
+            if (zsize <= min_zone_size || zsize <= largest_size[n])
+                break;
+            if (n < keep - 1)
+            {
+                largest[n + 1] = largest[n];
+                largest_size[n + 1] = largest_size[n];
+            }
+            largest[n] = z;
+            largest_size[n] = zsize;
+        }
+    }
+
+    for (int z = 0; z < (int) zones.size(); ++z)
+    {
+        if (!zones[z].floor
+            || find(largest.begin(), largest.end(), z) != largest.end())
+        {
+            continue;
+        }
+        for (const coord_def &c : zones[z].cells)
+            lines(c) = fill;
+    }
+
+    return 0;
+}
+
 LUAFN(dgn_is_passable_coord)
 {
     LINES(ls, 1, map, lines);
@@ -1359,6 +1506,62 @@ LUAFN(dgn_remove_isolated_glyphs)
     return 0;
 }
 
+// Replace each "find" glyph whose eight neighbours include between min_count
+// and max_count "count" glyphs, and no "forbid" glyphs. Every cell is judged
+// by the map as it was before the call, so the order of the walk doesn't
+// matter.
+LUAFN(dgn_replace_by_neighbors)
+{
+    LINES(ls, 1, map, lines);
+
+    TABLE_STR(ls, find, "");
+    TABLE_CHAR(ls, replace, '.');
+    TABLE_STR(ls, count, "");
+    TABLE_INT(ls, min_count, 1);
+    TABLE_INT(ls, max_count, 8);
+    TABLE_STR(ls, forbid, "");
+
+    int x1, y1, x2, y2;
+    if (!_coords(ls, lines, x1, y1, x2, y2))
+        return 0;
+
+    // we never change the border
+    x1 = max(x1, 1);
+    y1 = max(y1, 1);
+    x2 = min(x2, lines.width() - 2);
+    y2 = min(y2, lines.height() - 2);
+
+    vector<coord_def> changed;
+    for (int y = y1; y <= y2; ++y)
+        for (int x = x1; x <= x2; ++x)
+        {
+            if (!strchr(find, lines(x, y)))
+                continue;
+
+            int n = 0;
+            bool forbidden = false;
+            for (adjacent_iterator ai(coord_def(x, y)); ai; ++ai)
+            {
+                const char glyph = lines(*ai);
+                if (strchr(forbid, glyph))
+                {
+                    forbidden = true;
+                    break;
+                }
+                if (strchr(count, glyph))
+                    n++;
+            }
+
+            if (!forbidden && n >= min_count && n <= max_count)
+                changed.emplace_back(x, y);
+        }
+
+    for (const coord_def &c : changed)
+        lines(c) = replace;
+
+    return 0;
+}
+
 LUAFN(dgn_widen_paths)
 {
     LINES(ls, 1, map, lines);
@@ -2313,6 +2516,7 @@ const struct luaL_reg dgn_build_dlib[] =
     { "extend_map", &dgn_extend_map },
     { "fill_area", &dgn_fill_area },
     { "fill_disconnected", &dgn_fill_disconnected },
+    { "fill_small_zones", &dgn_fill_small_zones },
     { "find_in_area", &dgn_find_in_area },
     { "height", dgn_height },
     { "primary_vault_dimensions", &dgn_primary_vault_dimensions },
@@ -2328,6 +2532,7 @@ const struct luaL_reg dgn_build_dlib[] =
     { "mapgrd_table", dgn_mapgrd_table },
     { "octa_room", &dgn_octa_room },
     { "remove_isolated_glyphs", &dgn_remove_isolated_glyphs },
+    { "replace_by_neighbors", &dgn_replace_by_neighbors },
     { "widen_paths", &dgn_widen_paths },
     { "connect_adjacent_rooms", &dgn_connect_adjacent_rooms },
     { "remove_disconnected_doors", &dgn_remove_disconnected_doors },
@@ -34,6 +34,8 @@
 #include "colour.h"
 #include "cio.h"
 #include "crash.h"
+#include "end.h"
+#include "replay.h"
 #include "state.h"
 #include "tiles-build-specific.h"
 #include "unicode.h"
@@ -529,7 +531,7 @@ void set_getch_returns_resizes(bool rr)
     getch_returns_resizes = rr;
 }
 
-int getch_ck()
+static int _getch_ck()
 {
     while (true)
     {
@@ -590,6 +592,16 @@ int getch_ck()
     }
 }
 
+int getch_ck()
+{
+    if (replay_playing())
+        return replay_getch();
+
+    const int key = _getch_ck();
+    replay_note_key(key);
+    return key;
+}
+
 static void unix_handle_terminal_resize()
 {
     console_shutdown();
@@ -688,9 +700,20 @@ int unixcurses_get_vi_key(int keyin)
 #define KPADAPP "\033[?1051l\033[?1052l\033[?1060l\033[?1061h"
 #define KPADCUR "\033[?1051l\033[?1052l\033[?1060l\033[?1061l"
 
+// A headless replay still needs a curses screen for the UI to draw into,
+// but one that goes nowhere and leaves the terminal alone.
+static void _headless_screen()
+{
+    FILE *nowhere = fopen("/dev/null", "r+");
+    if (!nowhere || !newterm(const_cast<char *>("xterm"), nowhere, nowhere))
+        end(1, false, "Can't set up a screen for a headless replay.");
+}
+
 void console_startup()
 {
-    termio_init();
+    const bool headless = replay_headless();
+    if (!headless)
+        termio_init();
 
 #ifdef CURSES_USE_KEYPAD
     // If hardening is enabled (default on recent distributions), glibc
@@ -698,7 +721,7 @@ void console_startup()
     // only spams when not relevant, but cannot even be selectively hushed
     // by (void) casts like all other such warnings.
     // "if ();" is an unsightly hack...
-    if (write(1, KPADAPP, strlen(KPADAPP))) {};
+    if (!headless && write(1, KPADAPP, strlen(KPADAPP))) {};
 #endif
 
 #ifdef USE_UNIX_SIGNALS
@@ -707,7 +730,10 @@ void console_startup()
 # endif
 #endif
 
-    initscr();
+    if (headless)
+        _headless_screen();
+    else
+        initscr();
     raw();
     noecho();
 
@@ -753,6 +779,8 @@ void console_shutdown()
 {
     // resetty();
     endwin();
+    if (replay_headless())
+        return;
 
     tcsetattr(0, TCSAFLUSH, &def_term);
 #ifdef CURSES_USE_KEYPAD
@@ -824,8 +852,9 @@ void puttext(int x1, int y1, const crawl_view_buffer &vbuf)
 // C++ string class.  -- bwr
 void update_screen()
 {
-    // In objstat and similar modes, there might not be a screen to update.
-    if (stdscr)
+    // In objstat and similar modes, there might not be a screen to update;
+    // a headless replay's screen is never shown.
+    if (stdscr && !replay_headless())
     {
         // Refreshing the default colors helps keep colors synced in ttyrecs.
         curs_set_default_colors();
@@ -1577,7 +1606,7 @@ void delay(unsigned int time)
 }
 
 /* This is Juho Snellman's modified kbhit, to work with macros */
-bool kbhit()
+static bool _kbhit()
 {
     if (pending)
         return true;
@@ -1611,3 +1640,13 @@ bool kbhit()
     return result;
 #endif
 }
+
+bool kbhit()
+{
+    if (replay_playing())
+        return replay_kbhit();
+
+    const bool hit = _kbhit();
+    replay_note_kbhit(hit);
+    return hit;
+}
@@ -14,10 +14,12 @@
 #include <sstream>
 
 #include "colour.h"
+#include "end.h"
 #include "files.h"
 #include "message.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "tiles-build-specific.h"
 #include "unicode.h"
 #include "viewgeom.h"
@@ -36,6 +38,11 @@
     #include <csignal>
 #endif
 
+#ifndef TARGET_OS_WINDOWS
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
 #ifdef DGL_ENABLE_CORE_DUMP
     #include <sys/time.h>
     #include <sys/resource.h>
@@ -716,3 +723,96 @@ void release_cli_signals()
 }
 
 #endif
+
+/**
+ * Run jobs 0..jobs-1 over forked worker processes and gather their output.
+ *
+ * @param workers  How many processes to use; 0 or less means one per CPU.
+ *                 Clamped to [1, jobs], and always 1 on Windows. Updated to
+ *                 the number actually used.
+ * @param jobs     The number of jobs.
+ * @param name     Names the temporary files (name.N.part) and error messages.
+ * @param work     Called as work(first, workers, out) in each worker; it
+ *                 should run jobs first, first + workers, ..., writing one
+ *                 line per result to out, each prefixed with "<job>\t".
+ * @return         The lines written for each job, with the prefix removed,
+ *                 indexed by job.
+ */
+vector<vector<string>> run_worker_pool(int &workers, size_t jobs,
+                                       const string &name,
+                                       function<void(int, int, FILE *)> work)
+{
+#ifdef TARGET_OS_WINDOWS
+    workers = 1;
+#else
+    if (workers <= 0)
+        workers = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    workers = max(1, min<int>(workers, jobs));
+
+    vector<string> parts;
+    for (int w = 0; w < workers; ++w)
+        parts.push_back(make_stringf("%s.%d.part", name.c_str(), w));
+
+#ifndef TARGET_OS_WINDOWS
+    if (workers > 1)
+    {
+        vector<pid_t> pids;
+        for (int w = 0; w < workers; ++w)
+        {
+            fflush(stdout);
+            const pid_t pid = fork();
+            if (pid == -1)
+                end(1, true, "Couldn't fork %s worker", name.c_str());
+            if (pid == 0)
+            {
+                FILE *o = fopen_u(parts[w].c_str(), "w");
+                if (!o)
+                    _exit(1);
+                work(w, workers, o);
+                fclose(o);
+                _exit(0);
+            }
+            pids.push_back(pid);
+        }
+
+        for (pid_t pid : pids)
+        {
+            int status;
+            if (waitpid(pid, &status, 0) == -1
+                || !WIFEXITED(status) || WEXITSTATUS(status))
+            {
+                fprintf(stderr, "%s worker %d failed\n", name.c_str(),
+                        (int) pid);
+            }
+        }
+    }
+    else
+#endif
+    {
+        FILE *o = fopen_u(parts[0].c_str(), "w");
+        if (!o)
+            end(1, true, "Can't write %s", parts[0].c_str());
+        work(0, 1, o);
+        fclose(o);
+    }
+
+    // Merge the worker outputs back into job order.
+    vector<vector<string>> rows(jobs);
+    for (const string &part : parts)
+    {
+        {
+            UTF8FileLineInput in(part.c_str());
+            while (!in.eof())
+            {
+                const string line = in.get_line();
+                const string::size_type tab = line.find('\t');
+                const unsigned int i = atoi(line.c_str());
+                if (tab != string::npos && i < rows.size())
+                    rows[i].push_back(trimmed_string(line.substr(tab + 1)));
+            }
+        }
+        unlink_u(part.c_str());
+    }
+    return rows;
+}
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cctype>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -309,3 +310,7 @@ private:
 
 void init_signals();
 void release_cli_signals();
+
+vector<vector<string>> run_worker_pool(int &workers, size_t jobs,
+                                       const string &name,
+                                       function<void(int, int, FILE *)> work);
@@ -139,37 +139,30 @@ struct los_ray : public ray_def
     unsigned int start;
     unsigned int length;
 
-    los_ray(geom::ray _r)
-        : ray_def(_r), start(0), length(0)
+    // The ray is also kept in exact form: it starts at exact_start / den
+    // and heads in direction exact_dir.
+    coord_def exact_start;
+    int den;
+    coord_def exact_dir;
+
+    los_ray(const coord_def &_start, int _den, const coord_def &_dir)
+        : ray_def(geom::ray((double) _start.x / _den,
+                            (double) _start.y / _den, _dir.x, _dir.y)),
+          start(0), length(0), exact_start(_start), den(_den), exact_dir(_dir)
     {
     }
 
-    // Shoot a ray from the given start point (accx, accy) with the given
-    // slope, bounded by the pre-calc bounds shape.
+    // Shoot the ray, bounded by the pre-calc bounds shape.
     // Returns the cells it travels through, excluding the origin.
     // Returns an empty vector if this was a bad ray.
-    vector<coord_def> footprint()
+    vector<coord_def> footprint() const
     {
         vector<coord_def> cs;
-        los_ray copy = *this;
-        coord_def c;
-        coord_def old;
-        int cellnum;
-        for (cellnum = 0; true; ++cellnum)
+        if (!exact_footprint(exact_start, den, exact_dir, LOS_RADIUS, cs))
         {
-            old = c;
-            if (!copy.advance())
-            {
-//                dprf("discarding corner ray (%f,%f) + t*(%f,%f)",
-//                     r.start.x, r.start.y, r.dir.x, r.dir.y);
-                cs.clear();
-                break;
-            }
-            c = copy.pos();
-            if (c.rdist() > LOS_RADIUS)
-                break;
-            cs.push_back(c);
-            ASSERT((c - old).rdist() == 1);
+//            dprf("discarding corner ray (%f,%f) + t*(%f,%f)",
+//                 r.start.x, r.start.y, r.dir.x, r.dir.y);
+            cs.clear();
         }
         return cs;
     }
@@ -368,9 +361,10 @@ static vector<int> _find_minimal_cellrays()
 }
 
 // Create and register the ray defined by the arguments.
-static void _register_ray(geom::ray r)
+static void _register_ray(const coord_def &start, int den,
+                          const coord_def &dir)
 {
-    los_ray ray = los_ray(r);
+    los_ray ray = los_ray(start, den, dir);
     vector<coord_def> coords = ray.footprint();
 
     if (coords.empty() || _is_duplicate_ray(coords))
@@ -467,8 +461,8 @@ static void raycast()
 
     // register perpendiculars FIRST, to make them top choice
     // when selecting beams
-    _register_ray(geom::ray(0.5, 0.5, 0.0, 1.0));
-    _register_ray(geom::ray(0.5, 0.5, 1.0, 0.0));
+    _register_ray(coord_def(1, 1), 2, coord_def(0, 1));
+    _register_ray(coord_def(1, 1), 2, coord_def(1, 0));
 
     // For a slope of M = y/x, every x we move on the X axis means
     // that we move y on the y axis. We want to look at the resolution
@@ -492,14 +486,16 @@ static void raycast()
         const int xangle = xyangle.first;
         const int yangle = xyangle.second;
 
-        for (int intercept = 1; intercept < LOS_INTERCEPT_MULT*yangle; ++intercept)
+        // Starting points (intercept / den, 1/2).
+        const int den = LOS_INTERCEPT_MULT*yangle;
+        for (int intercept = 1; intercept < den; ++intercept)
         {
-            double xstart = ((double)intercept) / (LOS_INTERCEPT_MULT*yangle);
-            double ystart = 0.5;
+            const coord_def start(intercept, den / 2);
 
-            _register_ray(geom::ray(xstart, ystart, xangle, yangle));
+            _register_ray(start, den, coord_def(xangle, yangle));
             // also draw the identical ray in octant 2
-            _register_ray(geom::ray(ystart, xstart, yangle, xangle));
+            _register_ray(coord_def(start.y, start.x), den,
+                          coord_def(yangle, xangle));
         }
     }
 
@@ -507,16 +503,16 @@ static void raycast()
     _create_blockrays();
 }
 
-static int _imbalance(ray_def ray, const coord_def& target)
+// Longest run of straight or of diagonal steps along the cellray.
+static int _imbalance(const cellray& c)
 {
     int imb = 0;
     int diags = 0, straights = 0;
-    while (ray.pos() != target)
+    coord_def old;
+    for (unsigned int i = 0; i <= c.end; ++i)
     {
-        coord_def old = ray.pos();
-        if (!ray.advance())
-            die("can't advance ray");
-        switch ((ray.pos() - old).abs())
+        const coord_def cur = ray_coords[c.ray.start + i];
+        switch ((cur - old).abs())
         {
         case 1:
             diags = 0;
@@ -531,14 +527,14 @@ static int _imbalance(ray_def ray, const coord_def& target)
         default:
             die("ray imbalance out of range");
         }
+        old = cur;
     }
     return imb;
 }
 
 void cellray::calc_params()
 {
-    coord_def trg = target();
-    imbalance = _imbalance(ray, trg);
+    imbalance = _imbalance(*this);
     first_diag = ((*this)[0].abs() == 2);
 }
 
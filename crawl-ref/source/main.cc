@@ -114,6 +114,7 @@
 #include "quiver.h"
 #include "random.h"
 #include "religion.h"
+#include "replay.h"
 #include "shopping.h"
 #include "shout.h"
 #include "skills.h"
@@ -222,6 +223,39 @@ static void _startup_asserts()
         ASSERT(branches[i].id == i || branches[i].id == NUM_BRANCHES);
 }
 
+// With -replay, play on as if given the recording's command line, followed
+// by any other options (-dir, say) given alongside -replay.
+static void _replace_args_for_replay(int &argc, char **&argv)
+{
+    static vector<string> args;
+    static vector<char *> arg_ptrs;
+
+    int replay = 0;
+    for (int i = 1; i + 1 < argc; i++)
+        if (!strcmp(argv[i], "-replay") || !strcmp(argv[i], "--replay"))
+            replay = i;
+    if (!replay)
+        return;
+
+#ifdef USE_TILE_LOCAL
+    end(1, false, "-replay is only available in console builds.");
+#endif
+    replay_load(argv[replay + 1]);
+
+    args.push_back(argv[0]);
+    args.insert(args.end(), replay_args().begin(), replay_args().end());
+    for (int i = 1; i < argc; i++)
+        if (i != replay && i != replay + 1)
+            args.push_back(argv[i]);
+
+    for (string &arg : args)
+        arg_ptrs.push_back(&arg[0]);
+    arg_ptrs.push_back(nullptr);
+
+    argc = args.size();
+    argv = arg_ptrs.data();
+}
+
 //
 //  It all starts here. Some initialisations are run first, then straight
 //  to new_game and then input.
@@ -277,6 +311,8 @@ int main(int argc, char *argv[])
     get_system_environment();
     init_signals();
 
+    _replace_args_for_replay(argc, argv);
+
     // Parse command line args -- look only for initfile & crawl_dir entries.
     if (!parse_args(argc, argv, true))
     {
@@ -513,6 +549,11 @@ static void _show_commandline_options_help()
     puts("  -throttle             enable throttling of user Lua scripts");
     puts("  -seed <number>        specify a game seed to use when creating a new game");
 #endif
+#ifndef USE_TILE_LOCAL
+    puts("  -record <file>        record this session's input for replaying");
+    puts("  -replay <file>        replay a recorded session at full speed");
+    puts("  -headless             with -replay, show nothing until the end");
+#endif
 
     puts("");
 
@@ -534,6 +575,12 @@ static void _show_commandline_options_help()
     puts("");
     puts("Arena options: (Stage a tournament between various monsters.)");
     puts("  -arena \"<monster list> v <monster list> arena:<arena map>\"");
+    puts("  -arena-tournament <file>  fight every matchup in <file> headless "
+         "and write");
+    puts("      the results to arena-tournament.json; see docs/arena.txt");
+    puts("  -arena-workers <num>      For -arena-tournament, the number of "
+         "worker");
+    puts("      processes (default: one per CPU)");
 #ifdef DEBUG_DIAGNOSTICS
     puts("");
     puts("Diagnostic options:");
@@ -561,10 +608,23 @@ static void _show_commandline_options_help()
          "iterations");
     puts("  -force-map <map>    For -mapstat and -objstat, alway choose the "
          "      given map on every level.");
+#endif
+#ifdef WIZARD
+    puts("");
+    puts("Fight simulator options:");
+    puts("  -fsim <file>        run the fight simulator headless on every "
+         "matchup in <file>");
+    puts("      and write the results to fsim-batch.tsv; see "
+         "docs/fight_simulator.txt");
+    puts("  -fsim-workers <num> For -fsim, the number of worker processes "
+         "(default: one");
+    puts("      per CPU)");
 #endif
     puts("");
     puts("Miscellaneous options:");
     puts("  -dump-maps       write map Lua to stderr when parsing .des files");
+    puts("  -vault-rollback  undo vetoed minivaults instead of rebuilding the");
+    puts("                   whole level (changes the dungeon for a given seed)");
 #ifndef TARGET_OS_WINDOWS
     puts("  -gdb/-no-gdb     produce gdb backtrace when a crash happens (default:on)");
 #endif
@@ -2449,6 +2509,8 @@ void world_reacts()
 
         if (env.turns_on_level < INT_MAX)
             env.turns_on_level++;
+        replay_turn_done();
+        invalidate_item_names();
         record_turn_timestamp();
         update_turn_count();
         msgwin_new_turn();
@@ -1057,23 +1057,47 @@ void map_markers::activate_markers_at(coord_def p)
 
 void map_markers::add(map_marker *marker)
 {
-    markers.insert(dgn_pos_marker(marker->pos, marker));
+    link_marker(marker);
     have_inactive_markers = true;
 }
 
-void map_markers::unlink_marker(const map_marker *marker)
+void map_markers::link_marker(map_marker *marker)
+{
+    const dgn_pos_marker entry(marker->pos, marker);
+    markers.insert(entry);
+    markers_by_type[marker->get_type()].insert(entry);
+    if (marker->has_properties())
+    {
+        property_markers.insert(entry);
+        property_marker_set.insert(marker);
+    }
+}
+
+static void _erase_marker(multimap<coord_def, map_marker *> &mmap,
+                          const map_marker *marker)
 {
-    auto els = markers.equal_range(marker->pos);
+    auto els = mmap.equal_range(marker->pos);
     for (auto i = els.first; i != els.second; ++i)
     {
         if (i->second == marker)
         {
-            markers.erase(i);
+            mmap.erase(i);
             break;
         }
     }
 }
 
+void map_markers::unlink_marker(const map_marker *marker)
+{
+    _erase_marker(markers, marker);
+    _erase_marker(markers_by_type[marker->get_type()], marker);
+    if (marker->has_properties())
+    {
+        _erase_marker(property_markers, marker);
+        property_marker_set.erase(marker);
+    }
+}
+
 void map_markers::check_empty()
 {
     if (markers.empty())
@@ -1093,11 +1117,12 @@ void map_markers::remove_markers_at(const coord_def &c,
     auto els = markers.equal_range(c);
     for (auto i = els.first; i != els.second;)
     {
-        auto todel = i++;
-        if (type == MAT_ANY || todel->second->get_type() == type)
+        map_marker *marker = i->second;
+        ++i;
+        if (type == MAT_ANY || marker->get_type() == type)
         {
-            delete todel->second;
-            markers.erase(todel);
+            unlink_marker(marker);
+            delete marker;
         }
     }
     check_empty();
@@ -1114,28 +1139,17 @@ map_marker *map_markers::find(const coord_def &c, map_marker_type type)
 
 map_marker *map_markers::find(map_marker_type type)
 {
-    for (const auto &entry : markers)
-        if (type == MAT_ANY || entry.second->get_type() == type)
-            return entry.second;
-
-    return nullptr;
+    const dgn_marker_map &candidates = type == MAT_ANY ? markers
+                                                       : markers_by_type[type];
+    return candidates.empty() ? nullptr : candidates.begin()->second;
 }
 
 void map_markers::move(const coord_def &from, const coord_def &to)
 {
     unwind_bool inactive(have_inactive_markers);
-    auto els = markers.equal_range(from);
-
-    list<map_marker*> tmarkers;
-    for (auto i = els.first; i != els.second;)
-    {
-        auto curr = i++;
-        tmarkers.push_back(curr->second);
-        markers.erase(curr);
-    }
-
-    for (auto mark : tmarkers)
+    for (auto mark : get_markers_at(from))
     {
+        unlink_marker(mark);
         mark->pos = to;
         add(mark);
     }
@@ -1151,12 +1165,12 @@ void map_markers::move_marker(map_marker *marker, const coord_def &to)
 
 vector<map_marker*> map_markers::get_all(map_marker_type mat)
 {
+    const dgn_marker_map &candidates = mat == MAT_ANY ? markers
+                                                      : markers_by_type[mat];
     vector<map_marker*> rmarkers;
-    for (const auto &entry : markers)
-    {
-        if (mat == MAT_ANY || entry.second->get_type() == mat)
-            rmarkers.push_back(entry.second);
-    }
+    rmarkers.reserve(candidates.size());
+    for (const auto &entry : candidates)
+        rmarkers.push_back(entry.second);
     return rmarkers;
 }
 
@@ -1164,10 +1178,12 @@ vector<map_marker*> map_markers::get_all(const string &key, const string &val)
 {
     vector<map_marker*> rmarkers;
 
-    for (const auto &entry : markers)
+    // Lua property calls may add or remove markers, so work on a copy.
+    for (map_marker *marker : get_all_with_properties())
     {
-        map_marker*  marker = entry.second;
-        const string prop   = marker->property(key);
+        if (!contains(marker))
+            continue;
+        const string prop = marker->property(key);
 
         if (val.empty() && !prop.empty() || !val.empty() && val == prop)
             rmarkers.push_back(marker);
@@ -1176,6 +1192,26 @@ vector<map_marker*> map_markers::get_all(const string &key, const string &val)
     return rmarkers;
 }
 
+/// All markers that may have properties, in the usual (x-major) order.
+vector<map_marker*> map_markers::get_all_with_properties()
+{
+    vector<map_marker*> rmarkers;
+    rmarkers.reserve(property_markers.size());
+    for (const auto &entry : property_markers)
+        rmarkers.push_back(entry.second);
+    return rmarkers;
+}
+
+/**
+ * Is this marker (which may already have been deleted, so is not
+ * dereferenced) one of our markers with properties? For callers that hold
+ * on to markers across Lua property calls.
+ */
+bool map_markers::contains(const map_marker *marker) const
+{
+    return property_marker_set.count(marker);
+}
+
 vector<map_marker*> map_markers::get_markers_at(const coord_def &c)
 {
     auto els = markers.equal_range(c);
@@ -1208,6 +1244,10 @@ void map_markers::clear()
     for (auto &entry : markers)
         delete entry.second;
     markers.clear();
+    for (auto &type_markers : markers_by_type)
+        type_markers.clear();
+    property_markers.clear();
+    property_marker_set.clear();
     check_empty();
 }
 
@@ -1270,17 +1310,38 @@ coord_def find_marker_position_by_prop(const string &prop,
     return markers[0];
 }
 
+/**
+ * The markers that may have properties, in the row-major order the
+ * find_*_by_prop functions have always reported them in.
+ */
+static vector<map_marker*> _property_markers_by_row()
+{
+    vector<map_marker*> marks = env.markers.get_all_with_properties();
+    stable_sort(marks.begin(), marks.end(),
+                [](const map_marker *a, const map_marker *b)
+                {
+                    return a->pos.y < b->pos.y
+                           || (a->pos.y == b->pos.y && a->pos.x < b->pos.x);
+                });
+    return marks;
+}
+
 vector<coord_def> find_marker_positions_by_prop(const string &prop,
                                                 const string &expected,
                                                 unsigned maxresults)
 {
+    vector<coord_def> places;
+    for (const map_marker *mark : _property_markers_by_row())
+        if (places.empty() || places.back() != mark->pos)
+            places.push_back(mark->pos);
+
     vector<coord_def> marker_positions;
-    for (rectangle_iterator i(0, 0); i; ++i)
+    for (const coord_def &pos : places)
     {
-        const string value = env.markers.property_at(*i, MAT_ANY, prop);
+        const string value = env.markers.property_at(pos, MAT_ANY, prop);
         if (!value.empty() && (expected.empty() || value == expected))
         {
-            marker_positions.push_back(*i);
+            marker_positions.push_back(pos);
             if (maxresults && marker_positions.size() >= maxresults)
                 return marker_positions;
         }
@@ -1293,17 +1354,16 @@ vector<map_marker*> find_markers_by_prop(const string &prop,
                                          unsigned maxresults)
 {
     vector<map_marker*> markers;
-    for (rectangle_iterator pos(0, 0); pos; ++pos)
+    for (map_marker *mark : _property_markers_by_row())
     {
-        for (map_marker *mark : env.markers.get_markers_at(*pos))
+        if (!env.markers.contains(mark))
+            continue;
+        const string value(mark->property(prop));
+        if (!value.empty() && (expected.empty() || value == expected))
         {
-            const string value(mark->property(prop));
-            if (!value.empty() && (expected.empty() || value == expected))
-            {
-                markers.push_back(mark);
-                if (maxresults && markers.size() >= maxresults)
-                    return markers;
-            }
+            markers.push_back(mark);
+            if (maxresults && markers.size() >= maxresults)
+                return markers;
         }
     }
     return markers;
@@ -9,6 +9,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "beh-type.h"
@@ -63,6 +64,9 @@ public:
     virtual void read(reader &);
     virtual string debug_describe() const = 0;
     virtual string property(const string &pname) const;
+    // Can property() ever return anything? Markers that can't are left out
+    // of map_markers' property lookups.
+    virtual bool has_properties() const { return false; }
 
     static map_marker *read_marker(reader &);
     /// @throws bad_map_marker if text could not be parsed.
@@ -278,6 +282,7 @@ public:
     map_marker *clone() const override;
     string debug_describe() const override;
     string property(const string &pname) const override;
+    bool has_properties() const override { return true; }
 
     bool notify_dgn_event(const dgn_event &e) override;
 
@@ -307,6 +312,7 @@ public:
     void read(reader &) override;
     string debug_describe() const override;
     string property(const string &pname) const override;
+    bool has_properties() const override { return true; }
     string set_property(const string &key, const string &val);
     map_marker *clone() const override;
     static map_marker *read(reader &, map_marker_type);
@@ -359,6 +365,8 @@ public:
     void move_marker(map_marker *marker, const coord_def &to);
     vector<map_marker*> get_all(map_marker_type type = MAT_ANY);
     vector<map_marker*> get_all(const string &key, const string &val = "");
+    vector<map_marker*> get_all_with_properties();
+    bool contains(const map_marker *marker) const;
     vector<map_marker*> get_markers_at(const coord_def &c);
     string property_at(const coord_def &c, map_marker_type type,
                        const string &key);
@@ -375,11 +383,18 @@ private:
     typedef pair<coord_def, map_marker *> dgn_pos_marker;
 
     void init_from(const map_markers &);
+    void link_marker(map_marker *);
     void unlink_marker(const map_marker *);
     void check_empty();
 
 private:
     dgn_marker_map markers;
+    // Secondary indexes into markers, in the same order: markers of each
+    // type, and markers whose property() may be non-empty.
+    dgn_marker_map markers_by_type[NUM_MAP_MARKER_TYPES];
+    dgn_marker_map property_markers;
+    // The same markers as property_markers, for contains().
+    unordered_set<const map_marker *> property_marker_set;
     bool have_inactive_markers;
 };
 
@@ -127,15 +127,16 @@ static void _mons_summon_monster_illusion(monster* caster,
     }
 }
 
-static void _init_player_illusion_properties(monsterentry *me)
+static void _init_player_illusion_properties()
 {
-    me->holiness = you.holiness();
+    mon_holy_type holiness = you.holiness();
     // [ds] If we're cloning the player, use their base holiness, not
     // the effects of their Necromutation spell. This is important
     // since Necromutation users presumably also have Dispel Undead
     // available to them. :P
-    if (form_changed_physiology() && me->holiness & MH_UNDEAD)
-        me->holiness = MH_NATURAL;
+    if (form_changed_physiology() && holiness & MH_UNDEAD)
+        holiness = MH_NATURAL;
+    set_mons_class_holiness(MONS_PLAYER_ILLUSION, holiness);
 }
 
 // [ds] Not *all* appropriate enchantments are mapped -- only things
@@ -201,8 +202,7 @@ void mons_summon_illusion_from(monster* mons, actor *foe,
             else
                 mprf(MSGCH_WARN, "There is a horrible, sudden wrenching feeling in your soul!");
 
-            _init_player_illusion_properties(
-                get_monster_data(MONS_PLAYER_ILLUSION));
+            _init_player_illusion_properties();
             _mons_load_player_enchantments(mons, clone);
             clone->add_ench(ENCH_PHANTOM_MIRROR);
         }
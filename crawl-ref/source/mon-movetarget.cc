@@ -211,10 +211,20 @@ bool try_pathfind(monster* mon)
          mon->name(DESC_PLAIN).c_str(), mon->pos().x, mon->pos().y,
          targpos.x, targpos.y, range);
 #endif
+    // Hostiles hunting the same target can often share one search.
+    const maybe_bool shared = shared_travel_path(mon, targpos, range,
+                                                 mon->travel_path);
+    if (shared == MB_TRUE)
+    {
+        mon->target = mon->travel_path[0];
+        mon->travel_target = MTRAV_FOE;
+        return true;
+    }
+
     monster_pathfind mp;
     mp.set_range(range);
 
-    if (mp.init_pathfind(mon, targpos))
+    if (shared == MB_MAYBE && mp.init_pathfind(mon, targpos))
     {
         mon->travel_path = mp.calc_waypoints();
         if (!mon->travel_path.empty())
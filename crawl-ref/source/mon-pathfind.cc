@@ -2,12 +2,17 @@
 
 #include "mon-pathfind.h"
 
+#include <bitset>
+
+#include "coordit.h"
 #include "directn.h"
 #include "env.h"
+#include "level-id.h"
 #include "los.h"
 #include "misc.h"
 #include "mon-movetarget.h"
 #include "mon-place.h"
+#include "mon-tentacle.h"
 #include "religion.h"
 #include "state.h"
 #include "terrain.h"
@@ -357,8 +362,11 @@ vector<coord_def> monster_pathfind::backtrack()
 // avoid plants and other monsters in the way.
 vector<coord_def> monster_pathfind::calc_waypoints()
 {
-    vector<coord_def> path = backtrack();
+    return waypoints_along(backtrack());
+}
 
+vector<coord_def> monster_pathfind::waypoints_along(const vector<coord_def> &path)
+{
     // If no path found, nothing to be done.
     if (path.empty())
         return path;
@@ -523,3 +531,403 @@ void monster_pathfind::update_pos(coord_def npos, int total)
 
     add_new_pos(npos, total);
 }
+
+/////////////////////////////////////////////////////////////////////////////
+// monster_flowfield
+
+// When many hostiles chase the same target, each of them running its own
+// A* above repeats the same work. Instead, the second monster of a kind to
+// ask for a path to some destination in a turn gets a Dijkstra search run
+// outwards from the destination, bounded the same way as the A* search
+// would be, and it and any later ones read their paths off that. Only
+// monsters for which traversability and travel costs depend on nothing but
+// the properties compared in same_search() take part.
+
+monster_flowfield::search_key
+monster_flowfield::key_for(const monster* mon, coord_def dest, int r)
+{
+    return search_key(mon->type, mon->base_monster, mon->airborne(),
+                      mon->berserk_or_insane(), mons_enslaved_soul(*mon),
+                      dest, r);
+}
+
+monster_flowfield::monster_flowfield(const monster* mon, coord_def dest,
+                                     int r)
+    : key(key_for(mon, dest, r)), usable(true)
+{
+    mons = mon;
+    target = dest;
+    range = r;
+    traverse_in_sight = false;
+    fill();
+}
+
+void monster_flowfield::fill()
+{
+    for (int i = 0; i < GXM; i++)
+        for (int j = 0; j < GYM; j++)
+        {
+            dist[i][j] = INFINITE_DISTANCE;
+            traversable_cache[i][j] = MB_MAYBE;
+        }
+
+    // Hostile monsters that care about mechanical traps at all decide by
+    // where they are standing; see monster::is_trap_safe().
+    const bool traps_matter = mons_intel(*mons) != I_BRAINLESS
+                             && !mons->berserk_or_insane();
+
+    const int max_dist = range * 2;
+    dist[target.x][target.y] = 0;
+    hash[0].push_back(target);
+    for (int d = 0; d <= max_dist; d++)
+    {
+        // Costs are at least 1, so this bucket does not grow while we
+        // go through it.
+        for (coord_def p : hash[d])
+        {
+            if (dist[p.x][p.y] != d)
+                continue;
+
+            // The cost of stepping onto p from any neighbour.
+            pos = p;
+            const int cost = mons_travel_cost(p);
+            if (d + cost > max_dist)
+                continue;
+
+            for (int dir = 0; dir < 8; dir++)
+            {
+                const coord_def np = p + Compass[dir];
+                if (!in_bounds(np) || estimated_cost(np) > range)
+                    continue;
+                if (traps_matter)
+                {
+                    const trap_def *trap = trap_at(np);
+                    if (trap && trap->is_mechanical() && trap->type != TRAP_NET)
+                    {
+                        usable = false;
+                        hash[d].clear();
+                        for (int i = d + 1; i <= max_dist; i++)
+                            hash[i].clear();
+                        return;
+                    }
+                }
+                if (!traversable_memoized(np) || d + cost >= dist[np.x][np.y])
+                    continue;
+                dist[np.x][np.y] = d + cost;
+                hash[d + cost].push_back(np);
+            }
+        }
+        hash[d].clear();
+    }
+}
+
+// Follow the field downhill from mon's position, breaking ties the way the
+// A* search does: diagonals first, under a random quarter turn.
+vector<coord_def> monster_flowfield::calc_waypoints_for(const monster* mon)
+{
+    ASSERT(usable);
+    mons = mon;
+    start = mon->pos();
+
+    vector<coord_def> path;
+    path.push_back(start);
+    const int rotate = random2(4) * 2;
+    const int max_dist = range * 2;
+    int left = INFINITE_DISTANCE;
+    for (pos = start; pos != target; pos = path.back())
+    {
+        coord_def best;
+        int best_dist = INFINITE_DISTANCE;
+        for (int idir = 1; idir < 8; (idir += 2) == 9 && (idir = 0))
+        {
+            const coord_def np = pos + Compass[(idir + rotate) % 8];
+            if (!in_bounds(np) || estimated_cost(np) > range
+                || dist[np.x][np.y] == INFINITE_DISTANCE)
+            {
+                continue;
+            }
+            const int through = dist[np.x][np.y] + mons_travel_cost(np);
+            if (through < best_dist)
+            {
+                best = np;
+                best_dist = through;
+            }
+        }
+        // The rest of the path must get strictly cheaper every step; this
+        // also stops us at once if the start is cut off or too far.
+        if (best_dist == INFINITE_DISTANCE || dist[best.x][best.y] >= left
+            || (pos == start && best_dist > max_dist))
+        {
+            return vector<coord_def>();
+        }
+        left = dist[best.x][best.y];
+        path.push_back(best);
+    }
+
+    return waypoints_along(path);
+}
+
+static bool _can_share_flowfield(const monster* mon, int range)
+{
+    return mon->attitude == ATT_HOSTILE
+           && !mon->ghost
+           && !mons_is_tentacle_or_tentacle_segment(mon->type)
+           && mon->type != MONS_THORN_HUNTER
+           && mon->type != MONS_WANDERING_MUSHROOM
+           && range * 2 < GXM * GYM;
+}
+
+static vector<unique_ptr<monster_flowfield>> _flowfields;
+// Searches asked for once so far this turn, and not yet shared.
+static vector<monster_flowfield::search_key> _flowfield_requests;
+static int _flowfields_time = -1;
+static level_id _flowfields_place;
+
+// Each field is as large as a monster_pathfind, so only keep a few.
+static const size_t MAX_FLOWFIELDS = 8;
+
+/**
+ * Find waypoints for a hostile monster towards dest by way of a flow field
+ * shared with similar monsters hunting the same thing, if it can use one.
+ *
+ * @return MB_MAYBE if the caller should run its own search, otherwise
+ *         whether a path was found (and written to waypoints).
+ */
+maybe_bool shared_travel_path(const monster* mon, coord_def dest, int range,
+                              vector<coord_def> &waypoints)
+{
+    if (!_can_share_flowfield(mon, range) || mon->pos() == dest)
+        return MB_MAYBE;
+
+    if (you.elapsed_time != _flowfields_time
+        || level_id::current() != _flowfields_place)
+    {
+        _flowfields.clear();
+        _flowfield_requests.clear();
+        _flowfields_time = you.elapsed_time;
+        _flowfields_place = level_id::current();
+    }
+
+    const auto key = monster_flowfield::key_for(mon, dest, range);
+    monster_flowfield *field = nullptr;
+    for (auto &ff : _flowfields)
+        if (ff->key == key)
+            field = ff.get();
+
+    if (!field)
+    {
+        // A lone monster is better served by its own directed search, so
+        // only build a field once a second one wants the same thing.
+        auto req = find(_flowfield_requests.begin(), _flowfield_requests.end(),
+                        key);
+        if (req == _flowfield_requests.end())
+        {
+            _flowfield_requests.push_back(key);
+            return MB_MAYBE;
+        }
+        _flowfield_requests.erase(req);
+
+        if (_flowfields.size() >= MAX_FLOWFIELDS)
+            _flowfields.erase(_flowfields.begin());
+        _flowfields.emplace_back(new monster_flowfield(mon, dest, range));
+        field = _flowfields.back().get();
+    }
+
+    if (!field->usable)
+        return MB_MAYBE;
+
+    waypoints = field->calc_waypoints_for(mon);
+    return frombool(!waypoints.empty());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Reachability
+
+// Whether a monster could get to a cell at all, however far it searched,
+// depends only on the terrain and on which terrain it can cross. For the
+// safety checks, which ask this about every monster in view before each
+// rest and travel step, we keep the 8-connected components of the level for
+// each kind of movement, and leave the search proper to the cases where the
+// monster and its destination share a component.
+//
+// Cells count as passable here wherever monster_pathfind::traversable()
+// could possibly allow them, ignoring monsters, traps, runes and door
+// permissions, so that different components always mean "no path".
+
+struct reach_class
+{
+    bitset<NUM_FEATURES> passable;
+    // Union-find over cells (x + y * GXM); -1 for impassable cells. Empty
+    // when it needs to be built again.
+    vector<int> parent;
+};
+
+static vector<reach_class> _reach_classes;
+static map<pair<monster_type, bool>, size_t> _reach_class_of;
+static FixedArray<dungeon_feature_type, GXM, GYM> _reach_grid;
+static level_id _reach_place;
+static int _reach_time = -1;
+
+static int _reach_find(vector<int> &parent, int i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void _reach_join(vector<int> &parent, int a, int b)
+{
+    a = _reach_find(parent, a);
+    b = _reach_find(parent, b);
+    if (a != b)
+        parent[max(a, b)] = min(a, b);
+}
+
+// Make a newly passable cell part of its neighbours' components.
+static void _reach_add_cell(reach_class &rc, const coord_def &c)
+{
+    const int i = c.x + c.y * GXM;
+    rc.parent[i] = i;
+    for (int dir = 0; dir < 8; dir++)
+    {
+        const coord_def n = c + Compass[dir];
+        if (in_bounds(n) && rc.parent[n.x + n.y * GXM] != -1)
+            _reach_join(rc.parent, i, n.x + n.y * GXM);
+    }
+}
+
+static void _reach_build(reach_class &rc)
+{
+    rc.parent.assign(GXM * GYM, -1);
+    for (rectangle_iterator ri(0); ri; ++ri)
+        if (in_bounds(*ri) && rc.passable[env.grid(*ri)])
+            _reach_add_cell(rc, *ri);
+}
+
+// Bring the components up to date with the terrain: merging components
+// where cells have opened up, and starting again for any kind of movement
+// that some cell has closed to.
+static void _reach_sync()
+{
+    if (level_id::current() != _reach_place)
+    {
+        _reach_place = level_id::current();
+        _reach_grid = env.grid;
+        _reach_time = you.elapsed_time;
+        for (reach_class &rc : _reach_classes)
+            rc.parent.clear();
+        return;
+    }
+
+    if (_reach_time == you.elapsed_time)
+        return;
+    _reach_time = you.elapsed_time;
+
+    for (rectangle_iterator ri(0); ri; ++ri)
+    {
+        const dungeon_feature_type old_feat = _reach_grid(*ri);
+        const dungeon_feature_type new_feat = env.grid(*ri);
+        if (old_feat == new_feat)
+            continue;
+        _reach_grid(*ri) = new_feat;
+        if (!in_bounds(*ri))
+            continue;
+
+        for (reach_class &rc : _reach_classes)
+        {
+            if (rc.parent.empty()
+                || rc.passable[old_feat] == rc.passable[new_feat])
+            {
+                continue;
+            }
+            if (rc.passable[new_feat])
+                _reach_add_cell(rc, *ri);
+            else
+                rc.parent.clear();
+        }
+    }
+}
+
+static reach_class &_reach_class_for(const monster* mon)
+{
+    const monster_type mt = fixup_zombie_type(mon->type,
+                                              mons_base_type(*mon));
+    const auto key = make_pair(mt, mon->airborne());
+    auto found = _reach_class_of.find(key);
+    if (found != _reach_class_of.end())
+        return _reach_classes[found->second];
+
+    // Every kind of door counts as open: monster_pathfind lets monsters that
+    // can open doors path through closed ones, and too many cells here only
+    // means the caller falls back to searching.
+    reach_class rc;
+    for (int f = 0; f < NUM_FEATURES; f++)
+    {
+        const auto feat = static_cast<dungeon_feature_type>(f);
+        rc.passable[f] = feat_is_door(feat)
+                         || (monster_habitable_grid(mon, feat)
+                             && !feat_is_opaque(feat) && !feat_is_wall(feat));
+    }
+
+    // Monsters that move the same way share their components.
+    for (size_t i = 0; i < _reach_classes.size(); i++)
+        if (_reach_classes[i].passable == rc.passable)
+        {
+            _reach_class_of[key] = i;
+            return _reach_classes[i];
+        }
+
+    _reach_class_of[key] = _reach_classes.size();
+    _reach_classes.push_back(rc);
+    return _reach_classes.back();
+}
+
+/**
+ * Could this monster find a path to dest with monster_pathfind, given
+ * unlimited range? If this returns false it certainly could not; if true,
+ * the caller still has to search.
+ */
+bool mons_may_reach(const monster* mon, const coord_def &dest)
+{
+    // These path through the cover they hide in.
+    if (mon->type == MONS_THORN_HUNTER
+        || mon->type == MONS_WANDERING_MUSHROOM)
+    {
+        return true;
+    }
+
+    if (grid_distance(mon->pos(), dest) <= 1)
+        return true;
+
+    _reach_sync();
+    reach_class &rc = _reach_class_for(mon);
+    if (rc.parent.empty())
+        _reach_build(rc);
+
+    // Searches never check the start and destination themselves, so look
+    // at the components of the cells around them.
+    for (adjacent_iterator ai(mon->pos()); ai; ++ai)
+    {
+        if (!in_bounds(*ai) || rc.parent[ai->x + ai->y * GXM] == -1)
+            continue;
+        const int from = _reach_find(rc.parent, ai->x + ai->y * GXM);
+        for (adjacent_iterator di(dest, false); di; ++di)
+        {
+            if (in_bounds(*di) && rc.parent[di->x + di->y * GXM] != -1
+                && _reach_find(rc.parent, di->x + di->y * GXM) == from)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Terrain changed mid-turn; check it again before the next query.
+void reachability_terrain_changed()
+{
+    _reach_time = -1;
+}
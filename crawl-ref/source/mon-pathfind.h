@@ -4,6 +4,8 @@
 #include "defines.h"
 #include "fixedvector.h"
 #include "maybe-bool.h"
+#include "monster-type.h"
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -33,6 +35,7 @@ public:
 
 protected:
     // protected methods
+    vector<coord_def> waypoints_along(const vector<coord_def> &path);
     bool calc_path_to_neighbours();
     bool traversable(const coord_def& p);
     bool traversable_memoized(const coord_def& p);
@@ -78,3 +81,34 @@ protected:
 
     maybe_bool traversable_cache[GXM][GYM];
 };
+
+// Travel costs to a single destination from every cell within a tracking
+// range, for the hostile monsters of one kind that are all hunting it.
+// Here dist[][] holds the cost of the rest of the path from a cell to the
+// destination, and paths are read off it without a search of their own.
+class monster_flowfield : public monster_pathfind
+{
+public:
+    // Everything besides the level that a hostile monster's path depends on.
+    typedef tuple<monster_type, monster_type, bool, bool, bool, coord_def,
+                  int> search_key;
+    static search_key key_for(const monster* mon, coord_def dest, int range);
+
+    monster_flowfield(const monster* mon, coord_def dest, int range);
+
+    vector<coord_def> calc_waypoints_for(const monster* mon);
+
+    const search_key key;
+    // False if some cell's traversability depends on where the monster
+    // stands, as with mechanical traps, so that each needs its own search.
+    bool usable;
+
+private:
+    void fill();
+};
+
+maybe_bool shared_travel_path(const monster* mon, coord_def dest, int range,
+                              vector<coord_def> &waypoints);
+
+bool mons_may_reach(const monster* mon, const coord_def &dest);
+void reachability_terrain_changed();
@@ -9,6 +9,7 @@
 #include "mgen-data.h"
 
 #include <algorithm>
+#include <bitset>
 #include <functional>
 
 #include "abyss.h"
@@ -111,6 +112,60 @@ static bool _hab_requires_mon_flight(dungeon_feature_type g)
     return g == DNGN_LAVA || g == DNGN_DEEP_WATER;
 }
 
+// Which features a monster class can survive on depends only on its
+// habitat, whether it flies, and a couple of special cases. Each such
+// movement class gets a bitset of the features it can survive on, built
+// the first time it is needed, so that the per-cell checks made by monster
+// movement and pathfinding are a table lookup.
+enum
+{
+    MCLASS_SPECIAL_NONE,
+    MCLASS_SPECIAL_KRAKEN,
+    MCLASS_SPECIAL_ELDRITCH,
+    NUM_MCLASS_SPECIALS,
+    NUM_MOVEMENT_CLASSES = NUM_HABITATS * NUM_HABITATS * 2
+                           * NUM_MCLASS_SPECIALS,
+};
+
+static int _movement_class(monster_type mt)
+{
+    const int special =
+        mt == MONS_KRAKEN ? MCLASS_SPECIAL_KRAKEN
+        : mt == MONS_ELDRITCH_TENTACLE
+          || mt == MONS_ELDRITCH_TENTACLE_SEGMENT ? MCLASS_SPECIAL_ELDRITCH
+        : MCLASS_SPECIAL_NONE;
+    const int habitats = mons_class_primary_habitat(mt) * NUM_HABITATS
+                         + mons_class_secondary_habitat(mt);
+    return (habitats * 2 + mons_class_flag(mt, M_FLIES)) * NUM_MCLASS_SPECIALS
+           + special;
+}
+
+static const bitset<NUM_FEATURES> &_habitable_features(monster_type mt)
+{
+    static uint8_t mclass_of[NUM_MONSTERS];
+    static bitset<NUM_FEATURES> habitable[NUM_MOVEMENT_CLASSES];
+    static bitset<NUM_MOVEMENT_CLASSES> built;
+    COMPILE_CHECK(NUM_MOVEMENT_CLASSES < 255);
+
+    ASSERT_RANGE(mt, 0, NUM_MONSTERS);
+    // Stored off by one, so that zero means not worked out yet.
+    if (!mclass_of[mt])
+        mclass_of[mt] = _movement_class(mt) + 1;
+    const int mclass = mclass_of[mt] - 1;
+
+    if (!built[mclass])
+    {
+        for (int i = 0; i < NUM_FEATURES; ++i)
+        {
+            habitable[mclass][i] =
+                monster_habitable_grid(mt, static_cast<dungeon_feature_type>(i),
+                                       DNGN_UNSEEN);
+        }
+        built.set(mclass);
+    }
+    return habitable[mclass];
+}
+
 /**
  * Can this monster survive on actual_grid?
  *
@@ -127,7 +182,7 @@ bool monster_habitable_grid(const monster* mon,
     const monster_type mt = fixup_zombie_type(mon->type,
                                               mons_base_type(*mon));
 
-    bool type_safe = monster_habitable_grid(mt, actual_grid, DNGN_UNSEEN);
+    bool type_safe = _habitable_features(mt)[actual_grid];
     return type_safe ||
                     _hab_requires_mon_flight(actual_grid) && mon->airborne();
 }
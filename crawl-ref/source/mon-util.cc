@@ -72,6 +72,19 @@
 
 static FixedVector < int, NUM_MONSTERS > mon_entry;
 
+// The fields of mondata[] read by the common class predicates, copied out by
+// init_monsters() into arrays indexed directly by monster type. Checking a
+// class flag is then one load from a dense array, rather than a trip through
+// mon_entry to a whole monsterentry. Anything that changes one of these
+// fields in mondata[] during play must go through a setter that updates both
+// (see set_mons_class_holiness()).
+static monclass_flags_t mon_class_flags[NUM_MONSTERS];
+static mon_holy_type    mon_class_holiness[NUM_MONSTERS];
+static habitat_type     mon_class_habitat[NUM_MONSTERS];
+static size_type        mon_class_size[NUM_MONSTERS];
+static int8_t           mon_class_speed[NUM_MONSTERS];
+static mon_intel_type   mon_class_intel[NUM_MONSTERS];
+
 struct mon_display
 {
     char32_t glyph;
@@ -97,9 +110,10 @@ static int _mons_exp_mod(monster_type mclass);
 // Macro that saves some typing, nothing more.
 #define smc get_monster_data(mc)
 // ASSERT(smc) was getting really old
+// (get_monster_data() only fails for out of range types.)
 #define ASSERT_smc()                                                    \
     do {                                                                \
-        if (!get_monster_data(mc))                                      \
+        if (mc < 0 || mc >= NUM_MONSTERS)                               \
             die("bogus mc (no monster data): %s (%d)",                  \
                 mons_type_name(mc, DESC_PLAIN).c_str(), mc);            \
     } while (false)
@@ -268,6 +282,17 @@ void init_monsters()
         if (entry == -1)
             entry = mon_entry[MONS_PROGRAM_BUG];
 
+    for (monster_type mc = MONS_0; mc < NUM_MONSTERS; ++mc)
+    {
+        const monsterentry &me = mondata[mon_entry[mc]];
+        mon_class_flags[mc]    = me.bitfields;
+        mon_class_holiness[mc] = me.holiness;
+        mon_class_habitat[mc]  = me.habitat;
+        mon_class_size[mc]     = me.size;
+        mon_class_speed[mc]    = me.speed;
+        mon_class_intel[mc]    = me.intel;
+    }
+
     init_monster_symbols();
 }
 
@@ -437,8 +462,7 @@ monster* monster_at(const coord_def &pos)
 /// Are any of the bits set?
 bool mons_class_flag(monster_type mc, monclass_flags_t bits)
 {
-    const monsterentry * const me = get_monster_data(mc);
-    return me && (me->bitfields & bits);
+    return mc >= 0 && mc < NUM_MONSTERS && (mon_class_flags[mc] & bits);
 }
 
 int monster::wearing(equipment_type slot, int sub_type, bool calc_unid) const
@@ -684,7 +708,19 @@ string holiness_description(mon_holy_type holiness)
 mon_holy_type mons_class_holiness(monster_type mc)
 {
     ASSERT_smc();
-    return smc->holiness;
+    return mon_class_holiness[mc];
+}
+
+/**
+ * Change a monster class's holiness, both in mondata[] and in the copy the
+ * class predicates read. Only player illusions need this, to take on the
+ * holiness of the player they copy.
+ */
+void set_mons_class_holiness(monster_type mc, mon_holy_type holiness)
+{
+    ASSERT_smc();
+    get_monster_data(mc)->holiness = holiness;
+    mon_class_holiness[mc] = holiness;
 }
 
 bool mons_class_is_stationary(monster_type mc)
@@ -1264,8 +1300,7 @@ size_type mons_class_body_size(monster_type mc)
 {
     // Should pass base_type to get the right size for zombies, skeletons &c.
     // For normal monsters, base_type is set to type in the constructor.
-    const monsterentry *e = get_monster_data(mc);
-    return e ? e->size : SIZE_MEDIUM;
+    return mc >= 0 && mc < NUM_MONSTERS ? mon_class_size[mc] : SIZE_MEDIUM;
 }
 
 int max_corpse_chunks(monster_type mc)
@@ -3254,7 +3289,7 @@ static int _mons_exp_mod(monster_type mc)
 int mons_class_base_speed(monster_type mc)
 {
     ASSERT_smc();
-    return smc->speed;
+    return mon_class_speed[mc];
 }
 
 mon_energy_usage mons_class_energy(monster_type mc)
@@ -3306,7 +3341,7 @@ int mons_base_speed(const monster& mon, bool known)
 mon_intel_type mons_class_intel(monster_type mc)
 {
     ASSERT_smc();
-    return smc->intel;
+    return mon_class_intel[mc];
 }
 
 mon_intel_type mons_intel(const monster& m)
@@ -3322,14 +3357,13 @@ mon_intel_type mons_intel(const monster& m)
 static habitat_type _mons_class_habitat(monster_type mc,
                                         bool real_amphibious = false)
 {
-    const monsterentry *me = get_monster_data(mc);
-    habitat_type ht = (me ? me->habitat
-                          : get_monster_data(MONS_PROGRAM_BUG)->habitat);
+    if (mc < 0 || mc >= NUM_MONSTERS)
+        mc = MONS_PROGRAM_BUG;
+    habitat_type ht = mon_class_habitat[mc];
     if (!real_amphibious)
     {
         // XXX: No class equivalent of monster::body_size(PSIZE_BODY)!
-        size_type st = (me ? me->size
-                           : get_monster_data(MONS_PROGRAM_BUG)->size);
+        size_type st = mon_class_size[mc];
         if (ht == HT_LAND && st >= SIZE_GIANT || mc == MONS_GREY_DRACONIAN)
             ht = HT_AMPHIBIOUS;
     }
@@ -261,6 +261,7 @@ mon_holy_type holiness_by_name(string name);
 const char * holiness_name(mon_holy_type_flags which_holiness);
 string holiness_description(mon_holy_type holiness);
 mon_holy_type mons_class_holiness(monster_type mc);
+void set_mons_class_holiness(monster_type mc, mon_holy_type holiness);
 
 void discover_mimic(const coord_def& pos);
 void discover_shifter(monster& shifter);
@@ -74,9 +74,10 @@
 monster::monster()
     : hit_points(0), max_hit_points(0),
       speed(0), speed_increment(0), target(), firing_pos(),
-      patrol_point(), travel_target(MTRAV_NONE), inv(NON_ITEM), spells(),
+      patrol_point(), inv(NON_ITEM), spells(),
       attitude(ATT_HOSTILE), behaviour(BEH_WANDER), foe(MHITYOU),
-      enchantments(), flags(), xp_tracking(XP_NON_VAULT), experience(0),
+      travel_target(MTRAV_NONE), enchantments(), flags(),
+      xp_tracking(XP_NON_VAULT), experience(0),
       base_monster(MONS_NO_MONSTER), number(0), colour(COLOUR_INHERIT),
       foe_memory(0), god(GOD_NO_GOD), ghost(), seen_context(SC_NONE),
       client_id(0), hit_dice(0)
@@ -65,7 +65,6 @@ public:
     coord_def target;
     coord_def firing_pos;
     coord_def patrol_point;
-    mutable montravel_target_type travel_target;
     vector<coord_def> travel_path;
     FixedVector<short, NUM_MONSTER_SLOTS> inv;
     monster_spells spells;
@@ -73,6 +72,8 @@ public:
     beh_type behaviour;
     unsigned short foe;
     int8_t ench_countdown;
+    // Here rather than beside travel_path to fill what would be padding.
+    mutable montravel_target_type travel_target;
     mon_enchant_list enchantments;
     FixedBitVector<NUM_ENCHANTMENTS> ench_cache;
     monster_flags_t flags;             // bitfield of boolean flags
@@ -69,6 +69,14 @@ static bool _mons_has_path_to_player(const monster* mon)
         return false;
     }
 
+    // Walled-off monsters (plants behind glass, fish in a moat) are common
+    // enough that it pays to rule them out without a search.
+    if (!mons_may_reach(mon, you.pos()))
+    {
+        mon->travel_target = MTRAV_KNOWN_UNREACHABLE;
+        return false;
+    }
+
     // Try to find a path from monster to player, using the map as it's
     // known to the player and assuming unknown terrain to be traversable.
     monster_pathfind mp;
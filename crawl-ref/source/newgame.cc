@@ -2000,6 +2000,28 @@ static vector<weapon_choice> _get_weapons(const newgame_def& ng)
     return weapons;
 }
 
+/**
+ * The weapon a character starts with when nobody chooses one: the first
+ * recommended weapon in the menu's order, or else the first one allowed.
+ *
+ * @return the weapon, or WPN_UNKNOWN if the background has no weapon choice.
+ */
+weapon_type default_starting_weapon(const newgame_def& ng)
+{
+    if (species::mutation_level(ng.species, MUT_NO_GRASPING)
+        || !job_has_weapon_choice(ng.job))
+    {
+        return WPN_UNKNOWN;
+    }
+
+    const vector<weapon_choice> weapons = _get_weapons(ng);
+    ASSERT(!weapons.empty());
+    for (const weapon_choice &choice : weapons)
+        if (choice.second == CC_UNRESTRICTED)
+            return choice.first;
+    return weapons[0].first;
+}
+
 static void _resolve_weapon(newgame_def& ng, newgame_def& ng_choice,
                             const vector<weapon_choice>& weapons)
 {
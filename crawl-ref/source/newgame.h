@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "item-prop-enum.h"
 #include "job-type.h"
 #include "species-type.h"
 
@@ -25,6 +26,8 @@ bool choose_game(newgame_def& ng, newgame_def& choice,
 
 string newgame_random_name();
 
+weapon_type default_starting_weapon(const newgame_def& ng);
+
 /*
  * A structure for grouping backgrounds by category.
  */
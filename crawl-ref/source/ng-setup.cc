@@ -383,6 +383,9 @@ static void _setup_generic(const newgame_def& ng,
 void setup_game(const newgame_def& ng,
                 bool normal_dungeon_setup /*for catch2-tests */)
 {
+    // Don't reuse names rendered with a previous character's knowledge.
+    invalidate_item_names();
+
     crawl_state.type = ng.type; // by default
     if (Options.seed_from_rc && ng.type != GAME_TYPE_CUSTOM_SEED)
     {
@@ -330,6 +330,7 @@ public:
     int         travel_delay;   // How long to pause between travel moves
     int         explore_delay;  // How long to pause between explore moves
     int         rest_delay;     // How long to pause between rest moves
+    int         runrest_redraw_interval; // Max ms between undelayed frames
 
     bool        show_travel_trail;
 
@@ -404,7 +405,9 @@ public:
 
     vector<menu_sort_condition> sort_menus;
 
+    bool        legacy_level_catchup; // Catch up levels in separate passes.
     bool        dump_on_save;       // Automatically dump character when saving.
+    bool        background_save;    // Write checkpoints from a forked child.
     int         dump_kill_places;   // How to dump place information for kills.
     int         dump_message_count; // How many old messages to dump
 
@@ -16,6 +16,10 @@ Notes:
 * Readers always get the last complete (but not necessarily committed) write
   (ie, READ_UNCOMMITTED) at the time they started; it is safe to continue
   reading even if the chunk has been changed since.
+* fork_commit() hands the writes and the commit to a child process. The
+  guarantees above hold for the child as for any commit; the parent must
+  not touch the package until the child is reaped, which every other
+  public method does first.
 */
 
 #include "AppHdr.h"
@@ -32,12 +36,20 @@ Notes:
 #if defined(UNIX) || defined(TARGET_COMPILER_MINGW)
 #include <unistd.h>
 #endif
+#ifdef UNIX
+#include <cerrno>
+#include <csignal>
+#include <sys/wait.h>
+#endif
 
 #include "end.h"
 #include "endianness.h"
 #include "errors.h"
-#include "syscalls.h"
 #include "libutil.h" // map_find
+#include "message.h"
+#include "state.h"
+#include "stringutil.h"
+#include "syscalls.h"
 
 // debugging defines
 #undef  FSCK_VERBOSE
@@ -82,7 +94,7 @@ typedef map<plen_t, bm_p> bm_t;
 typedef map<plen_t, plen_t> fb_t;
 
 package::package(const char* file, bool writeable, bool empty)
-  : n_users(0), dirty(false), aborted(false)
+  : n_users(0), bg_pid(0), dirty(false), aborted(false)
 #ifdef DO_FSYNC
     , tmp(false)
 #endif
@@ -132,7 +144,7 @@ package::package(const char* file, bool writeable, bool empty)
 }
 
 package::package()
-  : rw(true), n_users(0), dirty(false), aborted(false)
+  : rw(true), n_users(0), bg_pid(0), dirty(false), aborted(false)
 #ifdef DO_FSYNC
     , tmp(true)
 #endif
@@ -186,6 +198,112 @@ void package::load()
         load_traces();
 }
 
+// Forget everything we know about the file and read it afresh.
+void package::reload()
+{
+    ASSERT(!n_users);
+    directory.clear();
+    free_blocks.clear();
+    unlinked_blocks.clear();
+    block_map.clear();
+    new_chunks.clear();
+    reader_count.clear();
+    dirty = false;
+
+    if (lseek(fd, 0, SEEK_SET) != 0)
+        sysfail("failed to seek inside the save file");
+    load();
+}
+
+/**
+ * Write and commit in a forked child, which works on a frozen copy of the
+ * game while this process carries on.
+ *
+ * @param serialize  Writes the chunks to commit. Runs only in the child.
+ * @return  Whether the child was started. If not, nothing has been written
+ *          and the caller should write and commit the usual way.
+ */
+bool package::fork_commit(const function<void()> &serialize)
+{
+#ifdef UNIX
+    ASSERT(rw);
+    await_background();
+    if (aborted || n_users)
+        return false;
+
+    const pid_t pid = fork();
+    if (pid == -1)
+        return false;
+
+    if (!pid)
+    {
+        // Finish the commit even if the terminal goes away, and never run
+        // the parent's exit handlers or our own destructor.
+        CrawlIsSaveChild = true;
+        signal(SIGHUP, SIG_IGN);
+        signal(SIGINT, SIG_IGN);
+        try
+        {
+            serialize();
+            commit();
+        }
+        catch (...)
+        {
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    bg_pid = pid;
+    return true;
+#else
+    UNUSED(serialize);
+    return false;
+#endif
+}
+
+/**
+ * Reap the child started by fork_commit(), if any. If it got as far as
+ * committing, the file has moved on without us and we reload it; otherwise
+ * the file still holds our last commit, and everything the child failed to
+ * write is still pending here for the next one. A child that did not exit
+ * cleanly is reported to the player.
+ */
+void package::await_background()
+{
+#ifdef UNIX
+    if (!bg_pid)
+        return;
+
+    int status;
+    pid_t reaped;
+    while ((reaped = waitpid(bg_pid, &status, 0)) == -1 && errno == EINTR)
+        ;
+    bg_pid = 0;
+
+    if (reaped != -1 && (!WIFEXITED(status) || WEXITSTATUS(status)))
+    {
+        const string why = WIFSIGNALED(status)
+            ? make_stringf("killed by signal %d", WTERMSIG(status))
+            : make_stringf("exit status %d", WEXITSTATUS(status));
+        dprintf("package: background commit failed (%s)\n", why.c_str());
+        if (crawl_state.io_inited)
+        {
+            mprf(MSGCH_ERROR, "Saving in the background failed (%s); "
+                              "the next save will try again.", why.c_str());
+        }
+    }
+
+    // A package that was never committed may not even have a header yet.
+    file_header head;
+    const bool have_head = lseek(fd, 0, SEEK_SET) == 0
+                           && ::read(fd, &head, sizeof(head)) == sizeof(head);
+    const plen_t *committed = map_find(directory, string());
+    if (have_head && (!committed || htole(head.start) != *committed))
+        reload();
+#endif
+}
+
 void package::load_traces()
 {
     ASSERT(!dirty);
@@ -208,6 +326,7 @@ void package::load_traces()
 package::~package()
 {
     dprintf("package: finalizing\n");
+    await_background();
     ASSERT(!n_users || CrawlIsCrashing); // not merely aborted, there are
         // live pointers to us. With normal stack unwinding, destructors
         // will make sure this never happens and this assert is good for
@@ -233,6 +352,7 @@ package::~package()
 
 void package::commit()
 {
+    await_background();
     ASSERT(rw);
     if (!dirty)
         return;
@@ -281,11 +401,13 @@ void package::seek(plen_t to)
 
 chunk_writer* package::writer(const string &name)
 {
+    await_background();
     return new chunk_writer(this, name);
 }
 
 chunk_reader* package::reader(const string &name)
 {
+    await_background();
     if (plen_t *ch = map_find(directory, name))
         return new chunk_reader(this, *ch);
     return 0;
@@ -384,6 +506,7 @@ void package::free_chunk(const string &name)
 
 void package::delete_chunk(const string &name)
 {
+    await_background();
     free_chunk(name);
     directory.erase(name);
 }
@@ -564,11 +687,13 @@ void package::read_directory(plen_t start, uint8_t version)
 
 bool package::has_chunk(const string &name)
 {
+    await_background();
     return !name.empty() && directory.count(name);
 }
 
 vector<string> package::list_chunks()
 {
+    await_background();
     vector<string> list;
     list.reserve(directory.size());
     for (const auto &entry : directory)
@@ -619,6 +744,7 @@ void package::abort()
     // Disable any further operations, allow a shutdown. All errors past
     // this point are ignored (assuming we already failed). All writes since
     // the last commit() are lost.
+    await_background();
     aborted = true;
 }
 
@@ -633,6 +759,7 @@ void package::unlink()
 // the amount of free space not at the end of file
 plen_t package::get_slack()
 {
+    await_background();
     load_traces();
 
     plen_t slack = 0;
@@ -643,6 +770,7 @@ plen_t package::get_slack()
 
 plen_t package::get_chunk_fragmentation(const string &name)
 {
+    await_background();
     load_traces();
     ASSERT(directory.count(name)); // not has_chunk(), "" is valid
     plen_t frags = 0;
@@ -659,6 +787,7 @@ plen_t package::get_chunk_fragmentation(const string &name)
 
 plen_t package::get_chunk_compressed_length(const string &name)
 {
+    await_background();
     load_traces();
     ASSERT(directory.count(name)); // not has_chunk(), "" is valid
     plen_t len = 0;
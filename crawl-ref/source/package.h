@@ -2,6 +2,7 @@
 
 #define USE_ZLIB
 
+#include <functional>
 #include <map>
 #include <set>
 #include <string>
@@ -83,6 +84,8 @@ public:
     vector<string> list_chunks();
     void abort();
     void unlink();
+    bool fork_commit(const std::function<void()> &serialize);
+    void await_background();
 
     // statistics
     plen_t get_slack();
@@ -95,6 +98,7 @@ private:
     int fd;
     plen_t file_len;
     int n_users;
+    int bg_pid;
     bool dirty;
     bool aborted;
 #ifdef DO_FSYNC
@@ -120,6 +124,7 @@ private:
     void trace_chunk(plen_t start);
     void load();
     void load_traces();
+    void reload();
     friend class chunk_writer;
     friend class chunk_reader;
 };
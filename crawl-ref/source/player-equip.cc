@@ -72,6 +72,7 @@ void equip_item(equipment_type slot, int item_slot, bool msg)
 
     equip_effect(slot, item_slot, false, msg);
     you.gear_change = true;
+    invalidate_item_names();
 }
 
 // Clear an equipment slot (possibly melded).
@@ -95,6 +96,7 @@ bool unequip_item(equipment_type slot, bool msg, bool skip_effects)
         ash_check_bondage();
         you.last_unequip = item_slot;
         you.gear_change = true;
+        invalidate_item_names();
         return true;
     }
 }
@@ -111,6 +113,7 @@ bool meld_slot(equipment_type slot)
     {
         you.melded.set(slot);
         you.gear_change = true;
+        invalidate_item_names();
         return true;
     }
     return false;
@@ -127,6 +130,7 @@ bool unmeld_slot(equipment_type slot)
     {
         you.melded.set(slot, false);
         you.gear_change = true;
+        invalidate_item_names();
         return true;
     }
     return false;
@@ -18,6 +18,7 @@
 #include "evoke.h"
 #include "fight.h"
 #include "invent.h"
+#include "item-name.h"
 #include "item-prop.h"
 #include "item-use.h"
 #include "items.h"
@@ -2372,6 +2373,7 @@ namespace quiver
         get()->invalidate();
         // TODO: abstract from `you`
         you.redraw_quiver = true;
+        invalidate_item_names();
     }
 
     /**
@@ -11,6 +11,7 @@
 #endif
 
 #include "pcg.h"
+#include "replay.h"
 #include "syscalls.h"
 #include "branch-type.h"
 #include "state.h"
@@ -165,10 +166,14 @@ namespace rng
 
     void seed()
     {
-        // seed both state and sequence from system randomness.
+        // seed both state and sequence from system randomness (or, when
+        // recording or replaying a session, from the recording).
         uint64_t seed_key[2];
-        bool seeded = read_urandom((char*)(&seed_key), sizeof(seed_key));
-        ASSERT(seeded);
+        if (!replay_entropy(seed_key))
+        {
+            bool seeded = read_urandom((char*)(&seed_key), sizeof(seed_key));
+            ASSERT(seeded);
+        }
         PcgRNG master = PcgRNG(seed_key[0], seed_key[1]);
         _do_seeding(master);
     }
@@ -534,3 +534,90 @@ void ray_def::bounce(const reflect_grid &rg)
     ASSERT(_valid());
     ASSERT(!rg(pos() - old_pos));
 }
+
+static int _floor_div(int n, int d)
+{
+    return n / d - (n % d != 0 && (n < 0) != (d < 0));
+}
+
+static int _sign(int n)
+{
+    return (n > 0) - (n < 0);
+}
+
+/**
+ * Find the cells met by a ray with rational start, exactly.
+ *
+ * This walks the same diamonds as repeatedly calling ray_def::advance() on
+ * ray_def(geom::ray(start.x / den, start.y / den, dir.x, dir.y)), but in
+ * integers: in the coordinates u = x + y - 1/2, v = x - y + 1/2 the diamonds
+ * are the even squares of the unit grid, so it is enough to order the
+ * crossings of the lines u = k and v = k by cross-multiplying.
+ *
+ * @param start  The starting point, scaled by den. It must be inside a
+ *               diamond.
+ * @param den    The common denominator of the start coordinates; even.
+ * @param dir    The direction of the ray.
+ * @param radius Stop at the first cell beyond this distance from the
+ *               starting cell, without recording it.
+ * @param cells  Filled with the cells met, not including the starting one.
+ * @return false if the ray passes through a corner between two
+ *         non-diamonds (where advance() would return false), in which case
+ *         cells holds the ones met before it.
+ */
+bool exact_footprint(const coord_def &start, int den, const coord_def &dir,
+                     int radius, vector<coord_def> &cells)
+{
+    ASSERT(den > 0 && den % 2 == 0);
+    ASSERT(!dir.origin());
+    cells.clear();
+
+    const int uq = start.x + start.y - den / 2;
+    const int vq = start.x - start.y + den / 2;
+    const int du = dir.x + dir.y;
+    const int dv = dir.x - dir.y;
+    const int su = _sign(du);
+    const int sv = _sign(dv);
+
+    int a = _floor_div(uq, den);
+    int b = _floor_div(vq, den);
+    ASSERT(uq % den != 0 && vq % den != 0 && (a + b) % 2 == 0);
+    const coord_def origin((a + b) / 2, (a - b) / 2);
+
+    // The next lines to be crossed.
+    int lu = a + (su > 0);
+    int lv = b + (sv > 0);
+
+    while (true)
+    {
+        // Crossing times, as (lu * den - uq) / (den * du) and the like.
+        const int nu = (lu * den - uq) * su;
+        const int nv = (lv * den - vq) * sv;
+        const int cmp = !du ? 1
+                      : !dv ? -1
+                            : nu * abs(dv) - nv * abs(du);
+
+        const bool was_diamond = (a + b) % 2 == 0;
+        if (cmp <= 0)
+        {
+            a += su;
+            lu += su;
+        }
+        if (cmp >= 0)
+        {
+            b += sv;
+            lv += sv;
+        }
+        // A corner joins either two diamonds or two non-diamonds.
+        if (!cmp && !was_diamond)
+            return false;
+
+        if ((a + b) % 2 == 0)
+        {
+            const coord_def c((a + b) / 2, (a - b) / 2);
+            if ((c - origin).rdist() > radius)
+                return true;
+            cells.push_back(c - origin);
+        }
+    }
+}
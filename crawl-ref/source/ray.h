@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "coord-def.h"
 #include "fixedarray.h"
 #include "geom2d.h"
@@ -29,3 +31,6 @@ struct ray_def
 
     bool _valid() const;
 };
+
+bool exact_footprint(const coord_def &start, int den, const coord_def &dir,
+                     int radius, std::vector<coord_def> &cells);
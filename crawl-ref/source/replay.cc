@@ -0,0 +1,506 @@
+/**
+ * @file
+ * @brief Recording a session's input, and replaying it at full speed for
+ *        benchmarking and regression testing.
+ *
+ * A recording holds the command line, init file (with the files it includes)
+ * and extra options of the session, the entropy that seeded its random number generators, and every
+ * key read from the console, along with how many times the game polled for
+ * input in between. Every REPLAY_CHECK_TURNS turns it also holds a hash of
+ * some game state, which a replay checks against its own.
+ *
+ * Recordings are only meaningful for new games played in a fresh save
+ * directory (a saved game or bones file the replay can't see will make it
+ * go its own way) and with the keyboard rather than the mouse.
+**/
+
+#include "AppHdr.h"
+
+#include "replay.h"
+
+#include <chrono>
+#include <cinttypes>
+
+#include "act-iter.h"
+#include "end.h"
+#include "files.h"
+#include "hash.h"
+#include "monster.h"
+#include "player.h"
+#include "random.h"
+#include "state.h"
+#include "stringutil.h"
+#include "syscalls.h"
+#include "unicode.h"
+#include "version.h"
+
+#define REPLAY_FORMAT "crawl-replay 1"
+#define REPLAY_CHECK_TURNS 100
+
+// A key as read from the console, with the input polls that preceded it.
+struct replay_key
+{
+    int key;
+    int misses;   // kbhit() calls that found nothing
+    int hits;     // kbhit() calls that found this key waiting
+    int delays;   // ui::delay() calls begun since the last key, if the key
+                  // was read during one; otherwise -1
+};
+
+struct replay_check
+{
+    size_t keys;
+    int turn;
+    uint32_t hash;
+};
+
+static FILE *record_file = nullptr;
+static string record_keys;
+static int record_key_tokens = 0;
+
+static bool playing = false;
+static vector<string> recorded_args;
+static bool have_options = false;
+static string recorded_rc;
+static vector<string> recorded_first;
+static vector<string> recorded_last;
+static map<string, string> recorded_includes;
+static set<string> includes_written;
+static bool headless = false;
+static vector<replay_key> recorded_keys;
+static vector<replay_check> recorded_checks;
+static size_t next_check = 0;
+static int checks_passed = 0;
+
+static bool have_entropy = false;
+static rng::PcgRNG entropy;
+
+// Input polls since the last key, in both modes.
+static size_t keys_done = 0;
+static int kbhit_misses = 0;
+static int kbhit_hits = 0;
+static int delays_since_key = 0;
+static int timed_depth = 0;
+
+static chrono::steady_clock::time_point replay_start;
+
+bool replay_recording()
+{
+    return record_file;
+}
+
+bool replay_playing()
+{
+    return playing;
+}
+
+static void _record_line(const string &line)
+{
+    fprintf(record_file, "%s\n", line.c_str());
+}
+
+static void _record_flush_keys()
+{
+    if (!record_file || record_keys.empty())
+        return;
+    _record_line("keys" + record_keys);
+    record_keys.clear();
+    record_key_tokens = 0;
+    fflush(record_file);
+}
+
+/// Finish the recording, if there is one.
+void replay_record_stop()
+{
+    _record_flush_keys();
+    if (record_file)
+        fclose(record_file);
+    record_file = nullptr;
+}
+
+namespace
+{
+    // Make sure the last few keys reach the file however the game exits.
+    struct record_closer
+    {
+        ~record_closer()
+        {
+            replay_record_stop();
+        }
+    } closer;
+}
+
+void replay_record_start(const string &filename, int argc, char **argv)
+{
+    if (record_file || playing)
+        return;
+
+    record_file = fopen_u(filename.c_str(), "w");
+    if (!record_file)
+        end(1, true, "Unable to open '%s' for recording", filename.c_str());
+
+    _record_line(REPLAY_FORMAT);
+    _record_line(string("version ") + Version::Long);
+
+    uint64_t key[2];
+    if (!read_urandom((char*)key, sizeof(key)))
+        end(1, false, "Unable to read system randomness for recording");
+    _record_line(make_stringf("entropy %" PRIu64 " %" PRIu64, key[0], key[1]));
+    entropy = rng::PcgRNG(key[0], key[1]);
+    have_entropy = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const string arg = argv[i];
+        if ((arg == "-record" || arg == "--record") && i + 1 < argc)
+        {
+            i++;
+            continue;
+        }
+        _record_line("arg " + arg);
+    }
+    fflush(record_file);
+}
+
+void replay_record_options(const string &rc_file,
+                           const vector<string> &first,
+                           const vector<string> &last)
+{
+    if (!record_file || have_options)
+        return;
+    have_options = true;
+
+    for (const string &opt : first)
+        _record_line("opt-first " + opt);
+
+    FileLineInput f(rc_file.c_str());
+    while (!f.error() && !f.eof())
+        _record_line("rc " + f.get_line());
+
+    for (const string &opt : last)
+        _record_line("opt-last " + opt);
+    fflush(record_file);
+}
+
+void replay_record_include(const string &name, const string &file)
+{
+    if (!record_file || includes_written.count(name))
+        return;
+    includes_written.insert(name);
+
+    _record_line("include " + name);
+    FileLineInput f(file.c_str());
+    while (!f.error() && !f.eof())
+        _record_line("inc " + f.get_line());
+    fflush(record_file);
+}
+
+bool replay_include(const string &name, string &text)
+{
+    if (!playing)
+        return false;
+    auto found = recorded_includes.find(name);
+    if (found == recorded_includes.end())
+        return false;
+    text = found->second;
+    return true;
+}
+
+void replay_set_headless()
+{
+    headless = true;
+}
+
+bool replay_headless()
+{
+    return playing && headless;
+}
+
+// Parse "key[/misses[/hits]][@delays]".
+static bool _parse_key(const string &token, replay_key &k)
+{
+    k.misses = k.hits = 0;
+    k.delays = -1;
+    const char *p = token.c_str();
+    char *endp;
+    k.key = strtol(p, &endp, 10);
+    if (endp == p)
+        return false;
+    if (*endp == '/')
+        k.misses = strtol(endp + 1, &endp, 10);
+    if (*endp == '/')
+        k.hits = strtol(endp + 1, &endp, 10);
+    if (*endp == '@')
+        k.delays = strtol(endp + 1, &endp, 10);
+    return !*endp;
+}
+
+void replay_load(const string &filename)
+{
+    FileLineInput f(filename.c_str());
+    if (f.error())
+        end(1, true, "Unable to open replay '%s'", filename.c_str());
+
+    if (f.get_line() != REPLAY_FORMAT)
+        end(1, false, "'%s' is not a replay", filename.c_str());
+
+    // The include whose lines are being read, if any.
+    string *include = nullptr;
+    while (!f.eof())
+    {
+        const string line = f.get_line();
+        const string::size_type space = line.find(' ');
+        const string kind = line.substr(0, space);
+        const string rest = space == string::npos ? "" : line.substr(space + 1);
+
+        if (kind == "version")
+        {
+            if (rest != Version::Long)
+            {
+                fprintf(stderr, "Replay was recorded with version %s.\n",
+                        rest.c_str());
+            }
+        }
+        else if (kind == "entropy")
+        {
+            uint64_t key[2];
+            if (sscanf(rest.c_str(), "%" SCNu64 " %" SCNu64,
+                       &key[0], &key[1]) != 2)
+            {
+                end(1, false, "Bad replay entropy: %s", rest.c_str());
+            }
+            entropy = rng::PcgRNG(key[0], key[1]);
+            have_entropy = true;
+        }
+        else if (kind == "arg")
+            recorded_args.push_back(rest);
+        else if (kind == "rc")
+        {
+            recorded_rc += rest + "\n";
+            have_options = true;
+        }
+        else if (kind == "opt-first")
+        {
+            recorded_first.push_back(rest);
+            have_options = true;
+        }
+        else if (kind == "opt-last")
+        {
+            recorded_last.push_back(rest);
+            have_options = true;
+        }
+        else if (kind == "include")
+            include = &recorded_includes[rest];
+        else if (kind == "inc")
+        {
+            if (!include)
+                end(1, false, "Replay include line outside an include");
+            *include += rest + "\n";
+        }
+        else if (kind == "keys")
+        {
+            for (const string &token : split_string(" ", rest))
+            {
+                replay_key k;
+                if (!_parse_key(token, k))
+                    end(1, false, "Bad replay key: %s", token.c_str());
+                recorded_keys.push_back(k);
+            }
+        }
+        else if (kind == "check")
+        {
+            replay_check c;
+            if (sscanf(rest.c_str(), "%zu %d %" SCNx32,
+                       &c.keys, &c.turn, &c.hash) != 3)
+            {
+                end(1, false, "Bad replay checkpoint: %s", rest.c_str());
+            }
+            recorded_checks.push_back(c);
+        }
+        else if (!kind.empty())
+            end(1, false, "Unknown replay line: %s", line.c_str());
+    }
+
+    if (!have_entropy)
+        end(1, false, "Replay '%s' has no entropy line", filename.c_str());
+
+    playing = true;
+    // Replays run as fast as they can.
+    crawl_state.disables.set(DIS_DELAY);
+    replay_start = chrono::steady_clock::now();
+}
+
+const vector<string> &replay_args()
+{
+    return recorded_args;
+}
+
+bool replay_options(string &rc, vector<string> &first, vector<string> &last)
+{
+    if (!playing || !have_options)
+        return false;
+    rc = recorded_rc;
+    first = recorded_first;
+    last = recorded_last;
+    return true;
+}
+
+bool replay_entropy(uint64_t key[2])
+{
+    if (!have_entropy)
+        return false;
+    key[0] = entropy.get_uint64();
+    key[1] = entropy.get_uint64();
+    return true;
+}
+
+static void _key_read()
+{
+    keys_done++;
+    kbhit_misses = kbhit_hits = 0;
+    delays_since_key = 0;
+}
+
+NORETURN static void _replay_finished()
+{
+    const double secs = chrono::duration<double>(
+        chrono::steady_clock::now() - replay_start).count();
+    end(0, false, "Replay finished: %zu keys, %d turns, %d/%zu checkpoints "
+                  "matched, %.3f seconds.",
+        keys_done, you.num_turns, checks_passed, recorded_checks.size(),
+        secs);
+}
+
+int replay_getch()
+{
+    ASSERT(playing);
+    if (keys_done >= recorded_keys.size())
+        _replay_finished();
+
+    const int key = recorded_keys[keys_done].key;
+    _key_read();
+    return key;
+}
+
+bool replay_kbhit()
+{
+    ASSERT(playing);
+    if (keys_done >= recorded_keys.size())
+        return false;
+
+    const replay_key &next = recorded_keys[keys_done];
+    if (timed_depth)
+        return next.delays == delays_since_key;
+
+    if (kbhit_misses < next.misses)
+    {
+        kbhit_misses++;
+        return false;
+    }
+    if (kbhit_hits < next.hits)
+        kbhit_hits++;
+    return next.hits > 0;
+}
+
+void replay_note_key(int key)
+{
+    if (!record_file)
+        return;
+
+    string token = make_stringf(" %d", key);
+    if (kbhit_misses || kbhit_hits)
+        token += make_stringf("/%d", kbhit_misses);
+    if (kbhit_hits)
+        token += make_stringf("/%d", kbhit_hits);
+    if (timed_depth)
+        token += make_stringf("@%d", delays_since_key);
+    record_keys += token;
+    _key_read();
+
+    if (++record_key_tokens >= 32)
+        _record_flush_keys();
+}
+
+void replay_note_kbhit(bool hit)
+{
+    // Polls in timed waits depend on the clock; the wait is recorded instead.
+    if (!record_file || timed_depth)
+        return;
+    if (hit)
+        kbhit_hits++;
+    else
+        kbhit_misses++;
+}
+
+replay_timed_wait::replay_timed_wait()
+{
+    if (!timed_depth++)
+        delays_since_key++;
+}
+
+replay_timed_wait::~replay_timed_wait()
+{
+    timed_depth--;
+}
+
+bool replay_timed_wait::key_due() const
+{
+    return playing && keys_done < recorded_keys.size()
+           && recorded_keys[keys_done].delays == delays_since_key;
+}
+
+static uint32_t _state_hash()
+{
+    vector<int64_t> state =
+    {
+        you.num_turns, you.elapsed_time, you.where_are_you, you.depth,
+        you.pos().x, you.pos().y, you.hp, you.magic_points,
+        you.experience, you.gold,
+        (int64_t) rng::get_states()[rng::GAMEPLAY],
+    };
+    for (monster_iterator mi; mi; ++mi)
+    {
+        state.push_back(mi->type);
+        state.push_back(mi->pos().x);
+        state.push_back(mi->pos().y);
+        state.push_back(mi->hit_points);
+    }
+    return hash32(state.data(), state.size() * sizeof(state[0]));
+}
+
+void replay_turn_done()
+{
+    if ((!record_file && !playing) || you.num_turns % REPLAY_CHECK_TURNS)
+        return;
+
+    const uint32_t hash = _state_hash();
+    if (record_file)
+    {
+        _record_flush_keys();
+        _record_line(make_stringf("check %zu %d %08" PRIx32, keys_done,
+                                  you.num_turns, hash));
+        fflush(record_file);
+        return;
+    }
+
+    while (next_check < recorded_checks.size()
+           && recorded_checks[next_check].turn < you.num_turns)
+    {
+        next_check++;
+    }
+    if (next_check >= recorded_checks.size()
+        || recorded_checks[next_check].turn != you.num_turns)
+    {
+        return;
+    }
+
+    const replay_check &check = recorded_checks[next_check++];
+    if (check.keys != keys_done || check.hash != hash)
+    {
+        end(1, false, "Replay diverged at turn %d: %zu keys read (recorded "
+                      "%zu), state hash %08" PRIx32 " (recorded %08" PRIx32
+                      ").", you.num_turns, keys_done, check.keys, hash,
+            check.hash);
+    }
+    checks_passed++;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @brief Recording a session's input, and replaying it at full speed for
+ *        benchmarking and regression testing.
+**/
+
+#pragma once
+
+void replay_record_start(const string &filename, int argc, char **argv);
+void replay_record_stop();
+void replay_load(const string &filename);
+bool replay_recording();
+bool replay_playing();
+
+// A headless replay keeps its screen to itself and skips drawing the view.
+void replay_set_headless();
+bool replay_headless();
+
+// The command line the recording was made with, for main() to parse in
+// place of the replay's own.
+const vector<string> &replay_args();
+
+// The init file text and extra options the recording was made with.
+bool replay_options(string &rc, vector<string> &first, vector<string> &last);
+void replay_record_options(const string &rc_file,
+                           const vector<string> &first,
+                           const vector<string> &last);
+
+// Files the init file includes, by the name it includes them by.
+void replay_record_include(const string &name, const string &file);
+bool replay_include(const string &name, string &text);
+
+// Stands in for system randomness while recording or replaying.
+bool replay_entropy(uint64_t key[2]);
+
+// Hooks for the console input layer.
+int replay_getch();
+bool replay_kbhit();
+void replay_note_key(int key);
+void replay_note_kbhit(bool hit);
+
+// Keys read while ui::delay() waits on a timer are tagged, so that a replay
+// (which does not wait) takes them at the same point.
+class replay_timed_wait
+{
+public:
+    replay_timed_wait();
+    ~replay_timed_wait();
+    bool key_due() const;
+};
+
+void replay_turn_done();
@@ -86,6 +86,12 @@ struct spell_desc
 
 static int spell_list[NUM_SPELLS];
 
+// The flags and schools of each spell, copied out of spelldata[] by
+// init_spell_descs() so that the common predicates read a dense array
+// indexed by spell instead of a whole spell_desc.
+static spell_flags spell_flag_list[NUM_SPELLS];
+static spschools_type spell_school_list[NUM_SPELLS];
+
 #define SPELLDATASIZE ARRAYSZ(spelldata)
 
 static const struct spell_desc *_seekspell(spell_type spellid);
@@ -132,6 +138,8 @@ void init_spell_descs()
         }
 
         spell_list[data.id] = i;
+        spell_flag_list[data.id] = data.flags;
+        spell_school_list[data.id] = data.disciplines;
     }
 }
 
@@ -413,7 +421,7 @@ bool spell_is_direct_explosion(spell_type spell)
 
 bool spell_harms_target(spell_type spell)
 {
-    const spell_flags flags = _seekspell(spell)->flags;
+    const spell_flags flags = get_spell_flags(spell);
 
     if (flags & (spflag::helpful | spflag::neutral))
         return false;
@@ -428,7 +436,7 @@ bool spell_harms_target(spell_type spell)
 
 bool spell_harms_area(spell_type spell)
 {
-    const spell_flags flags = _seekspell(spell)->flags;
+    const spell_flags flags = get_spell_flags(spell);
 
     if (flags & (spflag::helpful | spflag::neutral))
         return false;
@@ -522,7 +530,9 @@ int spell_levels_required(spell_type which_spell)
 
 spell_flags get_spell_flags(spell_type which_spell)
 {
-    return _seekspell(which_spell)->flags;
+    ASSERT_RANGE(which_spell, 0, NUM_SPELLS);
+    ASSERT(spell_list[which_spell] != -1);
+    return spell_flag_list[which_spell];
 }
 
 const char *get_spell_target_prompt(spell_type which_spell)
@@ -554,7 +564,9 @@ bool spell_typematch(spell_type which_spell, spschool which_disc)
 //jmf: next two for simple bit handling
 spschools_type get_spell_disciplines(spell_type spell)
 {
-    return _seekspell(spell)->disciplines;
+    ASSERT_RANGE(spell, 0, NUM_SPELLS);
+    ASSERT(spell_list[spell] != -1);
+    return spell_school_list[spell];
 }
 
 int count_bits(uint64_t bits)
@@ -62,6 +62,7 @@
  #include "windowmanager.h"
 #endif
 #include "ui.h"
+#include "wiz-fsim.h"
 
 using namespace ui;
 
@@ -169,6 +170,22 @@ static void _initialize()
     }
 #endif
 
+#ifdef WIZARD
+    if (!crawl_state.fsim_batch.empty())
+    {
+        release_cli_signals();
+        fsim_batch(crawl_state.fsim_batch, crawl_state.fsim_workers);
+        end(0, false);
+    }
+#endif
+
+    if (!crawl_state.arena_tournament.empty())
+    {
+        release_cli_signals();
+        arena_tournament(crawl_state.arena_tournament,
+                         crawl_state.arena_workers);
+    }
+
     if (!crawl_state.test_list)
     {
         if (!crawl_state.io_inited)
@@ -258,6 +275,9 @@ static void _post_init(bool newc)
 
     clua.load_persist();
 
+    // Item knowledge may come from a different game.
+    invalidate_item_names();
+
     // Load macros
     macro_init();
 
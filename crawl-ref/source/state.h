@@ -68,8 +68,18 @@ struct game_state
     bool map_stat_dump_disconnect; // Set if we dump disconnected maps and exit
                                    // under mapstat.
     bool obj_stat_gen;      // Set if we're generating object stats.
+    bool vault_rollback;    // Set if vetoed secondary vaults should be
+                            // rolled back instead of vetoing the level.
 
     string force_map;       // Set if we're forcing a specific map to generate.
+    string fsim_batch;      // Set to a matchup matrix to run a headless
+                            // fight simulator batch and exit.
+    int fsim_workers;       // Worker processes for the fsim batch; 0 means
+                            // one per CPU.
+    string arena_tournament; // Set to a list of matchups to fight headless
+                             // arena rounds and exit.
+    int arena_workers;      // Worker processes for the tournament; 0 means
+                            // one per CPU.
 
     game_type type;
     game_type last_type;
@@ -53,6 +53,7 @@
 #include "god-abil.h" // just for the Ru sac penalty key
 #include "god-passive.h"
 #include "god-companions.h"
+#include "hash.h"
 #include "item-name.h"
 #include "item-prop.h"
 #include "item-status-flag-type.h"
@@ -5998,6 +5999,26 @@ static void _tag_construct_level_monsters(writer &th)
     }
 }
 
+/**
+ * Identify the dungeon tile set this build was made with, so that a level
+ * can tell whether the tile numbers saved with it still mean the same thing.
+ */
+static uint32_t _tile_set_hash()
+{
+    static uint32_t hash = 0;
+    if (!hash)
+    {
+        string names;
+        for (tileidx_t idx = 0; idx < TILE_DNGN_MAX; ++idx)
+        {
+            names += tile_dngn_name(idx);
+            names += make_stringf(":%u\n", tile_dngn_count(idx));
+        }
+        hash = max<uint32_t>(1, hash32(names.data(), names.size()));
+    }
+    return hash;
+}
+
 void _tag_construct_level_tiles(writer &th)
 {
     // Map grids.
@@ -6037,6 +6058,7 @@ void _tag_construct_level_tiles(writer &th)
         }
 
     marshallInt(th, TILE_WALL_MAX);
+    marshallInt(th, _tile_set_hash());
 }
 
 static void _tag_read_level(reader &th)
@@ -7073,16 +7095,31 @@ void _tag_read_level_tiles(reader &th)
             tile_env.flv[x][y].floor_idx = unmarshallShort(th);
             tile_env.flv[x][y].feat_idx  = unmarshallShort(th);
 
-            // These get overwritten by _regenerate_tile_flavour
+            // These are rebuilt by _regenerate_tile_flavour, unless they
+            // were saved with our tile set.
             tile_env.flv[x][y].wall    = unmarshallShort(th);
             tile_env.flv[x][y].floor   = unmarshallShort(th);
             tile_env.flv[x][y].feat    = unmarshallShort(th);
             tile_env.flv[x][y].special = unmarshallShort(th);
         }
 
+    // If the tiles above were saved with the tile set we have, they are
+    // still good, and are what the level looked like when it was left.
+    bool same_tile_set = false;
+#if TAG_MAJOR_VERSION == 34
+    if (th.getMinorVersion() >= TAG_MINOR_TILE_SET_HASH)
+#endif
+    {
+        unmarshallInt(th); // TILE_WALL_MAX
+        same_tile_set = (uint32_t) unmarshallInt(th) == _tile_set_hash();
+    }
+
     _debug_count_tiles();
 
-    _regenerate_tile_flavour();
+    // Otherwise the saved tile numbers may not even exist in our tile set,
+    // so rebuild them from the tile names before anything draws them.
+    if (!same_tile_set)
+        _regenerate_tile_flavour();
 
     // Draw remembered map
     _draw_tiles();
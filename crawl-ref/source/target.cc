@@ -47,6 +47,34 @@ bool targeter::set_aim(coord_def a)
     return true;
 }
 
+bool targeter::preview_aim(coord_def a)
+{
+    if (preview_valid && a == preview_target)
+        return preview_ok;
+
+    preview_valid = true;
+    preview_target = a;
+    preview_ok = set_aim(a);
+    if (!preview_ok)
+        return false;
+
+    preview_centre = you.pos();
+    preview_map.init(AFF_NO);
+    const los_type los = can_affect_unseen() ? LOS_NONE : LOS_DEFAULT;
+    for (radius_iterator ri(preview_centre, los); ri; ++ri)
+        preview_map(*ri - preview_centre) = is_affected(*ri);
+    return true;
+}
+
+aff_type targeter::preview_affected(coord_def loc) const
+{
+    ASSERT(preview_valid && preview_ok);
+    const coord_def rel = loc - preview_centre;
+    if (rel.rdist() > LOS_MAX_RANGE)
+        return AFF_NO;
+    return static_cast<aff_type>(preview_map(rel));
+}
+
 bool targeter::can_affect_outside_range()
 {
     return false;
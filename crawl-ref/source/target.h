@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "beam.h"
+#include "fixedarray.h"
 #include "los-type.h"
 #include "reach-type.h"
 
@@ -25,7 +26,8 @@ enum aff_type // sign and non-zeroness matters
 class targeter
 {
 public:
-    targeter() :  agent(nullptr), obeys_mesmerise(false) {};
+    targeter() :  agent(nullptr), obeys_mesmerise(false),
+                  preview_valid(false), preview_ok(false) {};
     virtual ~targeter() {};
 
     coord_def origin;
@@ -42,8 +44,21 @@ public:
     virtual aff_type is_affected(coord_def loc) = 0;
     virtual bool can_affect_unseen();
     virtual bool affects_monster(const monster_info& mon);
+
+    // For targeting previews, which redraw every cell in view after each
+    // key: set_aim() and is_affected() for all those cells happen only
+    // when the aim changes, and later draws read the stored results.
+    bool preview_aim(coord_def a);
+    aff_type preview_affected(coord_def loc) const;
+    void clear_preview() { preview_valid = false; }
 protected:
     bool anyone_there(coord_def loc);
+private:
+    bool preview_valid;
+    bool preview_ok;
+    coord_def preview_target;
+    coord_def preview_centre;
+    SquareArray<int8_t, LOS_MAX_RANGE> preview_map;
 };
 
 class targeter_beam : public targeter
@@ -34,6 +34,7 @@
 #include "mapmark.h"
 #include "message.h"
 #include "mon-behv.h"
+#include "mon-pathfind.h"
 #include "mon-place.h"
 #include "mon-poly.h"
 #include "mon-util.h"
@@ -1924,6 +1925,8 @@ const char* feat_type_name(dungeon_feature_type feat)
 
 void set_terrain_changed(const coord_def p)
 {
+    reachability_terrain_changed();
+
     if (cell_is_solid(p))
         delete_cloud(p);
 
@@ -0,0 +1,244 @@
+#include "AppHdr.h"
+
+#ifdef USE_TILE_WEB
+
+#include "tileweb-ring.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+static const char RING_MAGIC[8] = { 'D', 'C', 'S', 'S', 'R', 'I', 'N', 'G' };
+static const uint32_t RING_VERSION = 1;
+static const size_t RING_RECORD_PREFIX = sizeof(uint32_t);
+
+webtiles_ring::webtiles_ring()
+    : m_owner(false), m_header(nullptr), m_data(nullptr), m_capacity(0),
+      m_map_size(0)
+{
+    static_assert(offsetof(ring_header, head) == 64, "ring layout changed");
+    static_assert(offsetof(ring_header, tail) == 128, "ring layout changed");
+    static_assert(offsetof(ring_header, waiting) == 192,
+                  "ring layout changed");
+    static_assert(sizeof(ring_header) == 256, "ring layout changed");
+}
+
+webtiles_ring::~webtiles_ring()
+{
+    close();
+}
+
+/**
+ * Create a fresh ring at the given path, replacing any stale one. The file
+ * is always a new one of our own: anything already at the path (a ring left
+ * by a crash, or a symlink planted in a shared directory) is unlinked, not
+ * opened.
+ *
+ * @param path      Where to create the backing file.
+ * @param capacity  Size of the data area; rounded up to a power of two.
+ * @return          Whether the ring could be created and mapped.
+ */
+bool webtiles_ring::create(const string &path, size_t capacity)
+{
+    close();
+
+    size_t cap = 4096;
+    while (cap < capacity)
+        cap <<= 1;
+
+    unlink(path.c_str());
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW,
+                    0600);
+    if (fd < 0)
+        return false;
+
+    const size_t size = sizeof(ring_header) + cap;
+    if (ftruncate(fd, size) < 0 || !_map(fd, size))
+    {
+        ::close(fd);
+        unlink(path.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    m_header = new (m_header) ring_header;
+    m_header->version = RING_VERSION;
+    m_header->unused = 0;
+    m_header->capacity = cap;
+    m_header->head.store(0);
+    m_header->tail.store(0);
+    m_header->waiting.store(0);
+    // Readers check the magic last, so write it last.
+    memcpy(m_header->magic, RING_MAGIC, sizeof(RING_MAGIC));
+
+    m_path = path;
+    m_owner = true;
+    m_capacity = cap;
+    return true;
+}
+
+/// Attach to a ring created by another process, as its consumer.
+bool webtiles_ring::open(const string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size <= sizeof(ring_header)
+        || !_map(fd, st.st_size))
+    {
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    const uint64_t cap = m_header->capacity;
+    if (memcmp(m_header->magic, RING_MAGIC, sizeof(RING_MAGIC))
+        || m_header->version != RING_VERSION
+        || cap == 0 || (cap & (cap - 1))
+        || cap != st.st_size - sizeof(ring_header))
+    {
+        close();
+        return false;
+    }
+
+    m_path = path;
+    m_owner = false;
+    m_capacity = cap;
+    return true;
+}
+
+/**
+ * Remove the backing file once the consumer has mapped it. Both mappings
+ * stay valid, and nothing is left behind if we crash.
+ */
+void webtiles_ring::unlink_file()
+{
+    if (m_owner && !m_path.empty())
+        unlink(m_path.c_str());
+    m_owner = false;
+}
+
+void webtiles_ring::close()
+{
+    if (m_header)
+        munmap(m_header, m_map_size);
+    if (m_owner && !m_path.empty())
+        unlink(m_path.c_str());
+
+    m_path.clear();
+    m_owner = false;
+    m_header = nullptr;
+    m_data = nullptr;
+    m_capacity = 0;
+    m_map_size = 0;
+}
+
+bool webtiles_ring::_map(int fd, size_t size)
+{
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED)
+        return false;
+
+    m_header = static_cast<ring_header *>(mem);
+    m_data = static_cast<char *>(mem) + sizeof(ring_header);
+    m_map_size = size;
+    return true;
+}
+
+void webtiles_ring::_copy_in(uint64_t pos, const char *src, size_t len)
+{
+    const size_t off = pos & (m_capacity - 1);
+    const size_t first = min(len, m_capacity - off);
+    memcpy(m_data + off, src, first);
+    memcpy(m_data, src + first, len - first);
+}
+
+void webtiles_ring::_copy_out(uint64_t pos, char *dst, size_t len) const
+{
+    const size_t off = pos & (m_capacity - 1);
+    const size_t first = min(len, m_capacity - off);
+    memcpy(dst, m_data + off, first);
+    memcpy(dst + first, m_data, len - first);
+}
+
+/**
+ * Append one message to the ring without ever blocking.
+ *
+ * @return  false if the ring is not open or the consumer has not yet made
+ *          enough room; the caller should hold on to the message and retry.
+ */
+bool webtiles_ring::push(const char *data, size_t len)
+{
+    if (!m_header)
+        return false;
+
+    const uint64_t head = m_header->head.load(std::memory_order_relaxed);
+    const uint64_t tail = m_header->tail.load(std::memory_order_acquire);
+    const uint64_t need = RING_RECORD_PREFIX + len;
+    if (need > m_capacity - (head - tail))
+        return false;
+
+    const uint32_t len32 = len;
+    _copy_in(head, reinterpret_cast<const char *>(&len32), RING_RECORD_PREFIX);
+    _copy_in(head + RING_RECORD_PREFIX, data, len);
+    // Sequentially consistent, pairing with set_waiting(): either the
+    // consumer sees this message when it re-checks, or we see its flag.
+    m_header->head.store(head + need);
+    return true;
+}
+
+bool webtiles_ring::empty() const
+{
+    return !m_header || m_header->head.load() == m_header->tail.load();
+}
+
+/// Did the consumer go to sleep? Clears the flag; the caller should wake it.
+bool webtiles_ring::take_waiting()
+{
+    return m_header && m_header->waiting.exchange(0) != 0;
+}
+
+/// Take the oldest message out of the ring, if there is one.
+bool webtiles_ring::pop(string &msg)
+{
+    if (!m_header)
+        return false;
+
+    const uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+    const uint64_t head = m_header->head.load(std::memory_order_acquire);
+    if (head == tail)
+        return false;
+
+    uint32_t len32 = 0;
+    _copy_out(tail, reinterpret_cast<char *>(&len32), RING_RECORD_PREFIX);
+    msg.resize(len32);
+    if (len32)
+        _copy_out(tail + RING_RECORD_PREFIX, &msg[0], len32);
+
+    m_header->tail.store(tail + RING_RECORD_PREFIX + len32,
+                         std::memory_order_release);
+    return true;
+}
+
+/**
+ * Announce that the consumer is about to sleep. If the ring is not empty
+ * afterwards, the consumer should drain it again before sleeping.
+ */
+void webtiles_ring::set_waiting()
+{
+    if (m_header)
+        m_header->waiting.store(1);
+}
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief Shared-memory message ring between crawl and the webtiles server.
+**/
+
+#pragma once
+
+#ifdef USE_TILE_WEB
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using std::string;
+
+/* A single-producer, single-consumer ring of length-prefixed messages
+   living in a file-backed shared mapping (normally under /dev/shm).
+
+   Crawl is the only producer. It never waits for the consumer: push()
+   fails immediately if there is not enough room, and the caller keeps
+   the message until a later push() succeeds. The consumer (the webtiles
+   server, or the stand-in reader used by the tests) sets the waiting flag
+   before it goes to sleep on the control socket, and the producer only
+   sends a wakeup datagram when that flag was set, so a busy consumer costs
+   no syscalls at all.
+
+   The layout is shared with webserver/connection.py and must be kept in
+   sync with it:
+
+     offset   0: char[8]  magic "DCSSRING"
+     offset   8: uint32   layout version
+     offset  16: uint64   capacity of the data area (a power of two)
+     offset  64: uint64   head: total bytes ever written (producer)
+     offset 128: uint64   tail: total bytes ever read (consumer)
+     offset 192: uint32   consumer waiting flag
+     offset 256: data area; each record is a uint32 length followed by the
+                 message bytes, wrapping around the end of the area.
+ */
+class webtiles_ring
+{
+public:
+    webtiles_ring();
+    ~webtiles_ring();
+
+    webtiles_ring(const webtiles_ring&) = delete;
+    webtiles_ring& operator=(const webtiles_ring&) = delete;
+
+    bool create(const string &path, size_t capacity);
+    bool open(const string &path);
+    void unlink_file();
+    void close();
+
+    bool is_open() const { return m_header != nullptr; }
+    const string &path() const { return m_path; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const;
+
+    // Producer side.
+    bool push(const char *data, size_t len);
+    bool take_waiting();
+
+    // Consumer side.
+    bool pop(string &msg);
+    void set_waiting();
+
+private:
+    struct ring_header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t unused;
+        uint64_t capacity;
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+        alignas(64) std::atomic<uint32_t> waiting;
+    };
+
+    bool _map(int fd, size_t size);
+    void _copy_in(uint64_t pos, const char *src, size_t len);
+    void _copy_out(uint64_t pos, char *dst, size_t len) const;
+
+    string m_path;
+    bool m_owner;
+    ring_header *m_header;
+    char *m_data;
+    size_t m_capacity;
+    size_t m_map_size;
+};
+
+#endif
@@ -78,8 +78,14 @@ static unsigned int get_milliseconds()
 TilesFramework tiles;
 
 TilesFramework::TilesFramework() :
+      m_ring_attached(false),
+      m_ring_backlog_size(0),
       m_controlled_from_web(false),
       _send_lock(false),
+      m_msg_generation(0),
+      m_join_snapshot_generation(0),
+      m_capture_join_snapshot(false),
+      m_snapshot_neutral(false),
       m_last_ui_state(UI_INIT),
       m_view_loaded(false),
       m_current_view(coord_def(GXM, GYM)),
@@ -107,6 +113,7 @@ void TilesFramework::shutdown()
     if (m_sock_name.empty())
         return;
 
+    m_ring.close();
     close(m_sock);
     remove(m_sock_name.c_str());
 }
@@ -127,6 +134,14 @@ bool TilesFramework::initialise()
     if (m_sock_name.empty())
         return true;
 
+    // Create the ring before the socket: the server waits for the socket to
+    // appear and then expects the ring to be there if it was asked for.
+    if (!m_ring_name.empty() && !m_ring.create(m_ring_name, 4 * 1024 * 1024))
+    {
+        fprintf(stderr, "Can't create the webtiles ring %s: %s\n",
+                m_ring_name.c_str(), strerror(errno));
+    }
+
     // Init socket
     m_sock = socket(PF_UNIX, SOCK_DGRAM, 0);
     if (m_sock < 0)
@@ -167,24 +182,50 @@ string TilesFramework::get_message()
 
 void TilesFramework::write_message(const char *format, ...)
 {
-    char buf[2048];
-    int len;
-
     va_list argp;
     va_start(argp, format);
-    if ((len = vsnprintf(buf, sizeof(buf), format, argp)) < 0)
-        die("Webtiles message format error! (%s)", format);
-    else if (len >= (int)sizeof(buf))
-        die("Webtiles message too long! (%d)", len);
+    _vwrite_message(format, argp);
     va_end(argp);
+}
+
+/**
+ * Format straight onto the end of m_msg_buf. Short pieces go through a
+ * stack buffer; anything longer is formatted a second time directly into
+ * the message buffer, which keeps its capacity between messages.
+ */
+void TilesFramework::_vwrite_message(const char *format, va_list argp)
+{
+    char buf[2048];
+    va_list again;
+    va_copy(again, argp);
+
+    const int len = vsnprintf(buf, sizeof(buf), format, argp);
+    if (len < 0)
+    {
+        va_end(again);
+        die("Webtiles message format error! (%s)", format);
+    }
 
-    m_msg_buf.append(buf);
+    if (len < (int)sizeof(buf))
+        m_msg_buf.append(buf, len);
+    else
+    {
+        const size_t old_size = m_msg_buf.size();
+        m_msg_buf.resize(old_size + len + 1);
+        vsnprintf(&m_msg_buf[old_size], len + 1, format, again);
+        m_msg_buf.resize(old_size + len);
+    }
+    va_end(again);
 }
 
 void TilesFramework::finish_message()
 {
     if (m_msg_buf.size() == 0)
         return;
+    if (m_capture_join_snapshot)
+        m_join_snapshot.push_back(m_msg_buf);
+    if (!m_snapshot_neutral)
+        m_msg_generation++;
 #ifdef DEBUG_WEBSOCKETS
     const int initial_buf_size = m_msg_buf.size();
     fprintf(stderr, "websocket: About to send %d bytes.\n", initial_buf_size);
@@ -197,6 +238,9 @@ void TilesFramework::finish_message()
     }
 
     m_msg_buf.append("\n");
+    if (m_ring_attached)
+        _ring_send(m_msg_buf);
+
     const char* fragment_start = m_msg_buf.data();
     const char* data_end = m_msg_buf.data() + m_msg_buf.size();
     int fragments = 0;
@@ -209,6 +253,9 @@ void TilesFramework::finish_message()
 
         for (unsigned int i = 0; i < m_dest_addrs.size(); ++i)
         {
+            if (m_ring_attached && _is_ring_dest(m_dest_addrs[i]))
+                continue;
+
             int retries = 30;
             ssize_t sent = 0;
             while (sent < fragment_size)
@@ -279,24 +326,105 @@ void TilesFramework::finish_message()
 #endif
 }
 
-void TilesFramework::send_message(const char *format, ...)
+bool TilesFramework::_is_ring_dest(const sockaddr_un &addr) const
 {
-    char buf[2048];
-    int len;
+    return !strncmp(addr.sun_path, m_ring_dest.sun_path,
+                    sizeof(addr.sun_path));
+}
 
-    va_list argp;
-    va_start(argp, format);
-    if ((len = vsnprintf(buf, sizeof(buf), format, argp)) >= (int)sizeof(buf)
-        || len == -1)
+/**
+ * Queue a complete message on the shared-memory ring. This never waits for
+ * the server: whatever does not fit stays in the backlog and is retried on
+ * the next message, or while waiting for input. Like the datagram path,
+ * messages are split into fragments and the server reassembles them up to
+ * the trailing newline.
+ */
+void TilesFramework::_ring_send(const string &msg)
+{
+    // Give up on a server that has stopped reading altogether, as the
+    // datagram path does when the other side goes away.
+    const size_t max_backlog = 64 * 1024 * 1024;
+    const size_t max_fragment = m_ring.capacity() / 4;
+
+    _ring_drain_backlog();
+    if (!m_ring_attached)
+        return;
+    for (size_t pos = 0; pos < msg.size(); pos += max_fragment)
     {
-        if (len == -1)
-            die("Webtiles message format error! (%s)", format);
-        else
-            die("Webtiles message too long! (%d)", len);
+        const size_t len = min(max_fragment, msg.size() - pos);
+        if (!m_ring_backlog.empty() || !m_ring.push(msg.data() + pos, len))
+        {
+            m_ring_backlog.emplace_back(msg, pos, len);
+            m_ring_backlog_size += len;
+        }
     }
-    va_end(argp);
 
-    m_msg_buf.append(buf);
+    if (m_ring_backlog_size > max_backlog)
+    {
+#ifdef DEBUG_WEBSOCKETS
+        fprintf(stderr, "websocket: ring backlog overflow, detaching.\n");
+#endif
+        _ring_detach();
+        return;
+    }
+
+    _ring_wake();
+}
+
+/**
+ * Wake the server if it went to sleep on the socket; a server that is still
+ * draining the ring will see new data by itself.
+ */
+void TilesFramework::_ring_wake()
+{
+    if (m_ring.take_waiting()
+        && sendto(m_sock, "", 0, MSG_DONTWAIT, (sockaddr*) &m_ring_dest,
+                  sizeof(sockaddr_un)) < 0
+        && (errno == ECONNREFUSED || errno == ENOENT))
+    {
+        _ring_detach();
+    }
+}
+
+void TilesFramework::_ring_drain_backlog()
+{
+    bool pushed = false;
+    while (!m_ring_backlog.empty())
+    {
+        const string &frag = m_ring_backlog.front();
+        if (!m_ring.push(frag.data(), frag.size()))
+            break;
+        m_ring_backlog_size -= frag.size();
+        m_ring_backlog.pop_front();
+        pushed = true;
+    }
+
+    if (pushed)
+        _ring_wake();
+}
+
+/// The ring's consumer is gone; forget it like a dead datagram receiver.
+void TilesFramework::_ring_detach()
+{
+    for (unsigned int i = 0; i < m_dest_addrs.size(); ++i)
+    {
+        if (_is_ring_dest(m_dest_addrs[i]))
+        {
+            m_dest_addrs.erase(m_dest_addrs.begin() + i);
+            break;
+        }
+    }
+    m_ring_attached = false;
+    m_ring_backlog.clear();
+    m_ring_backlog_size = 0;
+}
+
+void TilesFramework::send_message(const char *format, ...)
+{
+    va_list argp;
+    va_start(argp, format);
+    _vwrite_message(format, argp);
+    va_end(argp);
 
     finish_message();
 }
@@ -309,6 +437,7 @@ void TilesFramework::flush_messages()
 
     if (m_need_flush)
     {
+        unwind_bool neutral(m_snapshot_neutral, true);
         send_message("*{\"msg\":\"flush_messages\"}");
         m_need_flush = false;
     }
@@ -375,6 +504,17 @@ wint_t TilesFramework::_handle_control_message(sockaddr_un addr, string data)
 
         m_dest_addrs.push_back(addr);
         m_controlled_from_web = primary->bool_;
+
+        // A server that mapped our ring reads from it instead of the socket,
+        // unless an earlier reader left messages behind.
+        JsonNode *shm = json_find_member(obj.node, "shm");
+        if (shm && shm->tag == JSON_BOOL && shm->bool_
+            && m_ring.is_open() && !m_ring_attached && m_ring.empty())
+        {
+            m_ring_dest = addr;
+            m_ring_attached = true;
+            m_ring.unlink_file();
+        }
     }
     else if (msgtype == "key")
     {
@@ -486,7 +626,18 @@ bool TilesFramework::await_input(wint_t& c, bool block)
             if (!m_sock_name.empty())
                 FD_SET(m_sock, &fds);
 
-            if (block)
+            if (block && !m_ring_backlog.empty())
+            {
+                // Keep feeding a slow server from the backlog while we wait.
+                tiles.flush_messages();
+                _ring_drain_backlog();
+                timeval timeout;
+                timeout.tv_sec = 0;
+                timeout.tv_usec = 10 * 1000;
+
+                result = select(maxfd + 1, &fds, nullptr, nullptr, &timeout);
+            }
+            else if (block)
             {
                 tiles.flush_messages();
                 result = select(maxfd + 1, &fds, nullptr, nullptr, nullptr);
@@ -502,7 +653,9 @@ bool TilesFramework::await_input(wint_t& c, bool block)
         }
         while (result == -1 && errno == EINTR);
 
-        if (result == 0)
+        if (result == 0 && block)
+            continue;
+        else if (result == 0)
             return false;
         else if (result > 0)
         {
@@ -795,6 +948,12 @@ void TilesFramework::update_input_mode(mouse_mode mode, bool force)
         redraw();
     }
 
+    _send_input_mode(mode);
+}
+
+void TilesFramework::_send_input_mode(mouse_mode mode)
+{
+    unwind_bool neutral(m_snapshot_neutral, true);
     json_open_object();
     json_write_string("msg", "input_mode");
     json_write_int("mode", mode);
@@ -1875,15 +2034,38 @@ void TilesFramework::_send_messages()
     if (_send_lock)
         return;
     unwind_bool no_rentry(_send_lock, true);
+    unwind_bool neutral(m_snapshot_neutral, true);
 
     webtiles_send_messages();
 }
 
 /*
-  Send everything a newly joined spectator needs
+  Send the part of a newly joined spectator's state that everybody else
+  already has. Diffs sent afterwards are computed against this state, so
+  as long as none have been sent since the last join, its bytes can be
+  resent as they are instead of being rebuilt.
  */
-void TilesFramework::_send_everything()
+void TilesFramework::_send_join_snapshot()
 {
+    if (!m_join_snapshot.empty()
+        && m_join_snapshot_generation == m_msg_generation)
+    {
+#ifdef DEBUG_WEBSOCKETS
+        fprintf(stderr, "websocket: Resending %u cached join messages.\n",
+                (unsigned int) m_join_snapshot.size());
+#endif
+        unwind_bool neutral(m_snapshot_neutral, true);
+        for (const string &msg : m_join_snapshot)
+        {
+            m_msg_buf = msg;
+            finish_message();
+        }
+        return;
+    }
+
+    m_join_snapshot.clear();
+    unwind_bool capture(m_capture_join_snapshot, true);
+
     _send_version();
     _send_options();
     _send_layout();
@@ -1939,11 +2121,24 @@ void TilesFramework::_send_everything()
     json_close_object();
     finish_message();
 
+    m_join_snapshot_generation = m_msg_generation;
+}
+
+/*
+  Send everything a newly joined spectator needs
+ */
+void TilesFramework::_send_everything()
+{
+    _send_join_snapshot();
+
     _send_messages();
 
     update_input_mode(mouse_control::current_mode(), true);
 
-    m_text_menu.send(true);
+    {
+        unwind_bool neutral(m_snapshot_neutral, true);
+        m_text_menu.send(true);
+    }
 
     ui::sync_ui_state();
 }
@@ -2204,23 +2399,63 @@ bool TilesFramework::cell_needs_redraw(const coord_def& gc)
     return m_cells_needing_redraw[gc.y * GXM + gc.x];
 }
 
+/// Does any byte of w need escaping in a JSON string (", \\ or < 0x20)?
+static inline bool _json_word_needs_escape(uint64_t w)
+{
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    const uint64_t quote = w ^ (ones * '"');
+    const uint64_t slash = w ^ (ones * '\\');
+    return (((quote - ones) & ~quote)
+            | ((slash - ones) & ~slash)
+            | ((w - ones * 0x20) & ~w)) & highs;
+}
+
+/**
+ * Append s with JSON string escaping. Text that needs no escaping, which is
+ * nearly all of it, is found eight bytes at a time and copied in runs.
+ */
 void TilesFramework::write_message_escaped(const string& s)
 {
-    for (unsigned char c : s)
+    static const char hex[] = "0123456789abcdef";
+
+    const char *p = s.data();
+    const char *const end = p + s.size();
+    const char *run = p;
+    while (p < end)
     {
+        if (end - p >= 8)
+        {
+            uint64_t w;
+            memcpy(&w, p, sizeof(w));
+            if (!_json_word_needs_escape(w))
+            {
+                p += 8;
+                continue;
+            }
+        }
+
+        const unsigned char c = *p;
+        if (c != '"' && c != '\\' && c >= 0x20)
+        {
+            ++p;
+            continue;
+        }
+
+        m_msg_buf.append(run, p - run);
         if (c == '"')
-            m_msg_buf.append("\\\"");
+            m_msg_buf.append("\\\"", 2);
         else if (c == '\\')
-            m_msg_buf.append("\\\\");
-        else if (c < 0x20)
+            m_msg_buf.append("\\\\", 2);
+        else
         {
-            char buf[7];
-            snprintf(buf, sizeof(buf), "\\u%04x", c);
-            m_msg_buf.append(buf);
+            const char esc[] = { '\\', 'u', '0', '0', hex[c >> 4],
+                                 hex[c & 0xf] };
+            m_msg_buf.append(esc, sizeof(esc));
         }
-        else
-            m_msg_buf.push_back(c);
+        run = ++p;
     }
+    m_msg_buf.append(run, p - run);
 }
 
 void TilesFramework::json_open(const string& name, char opener, char type)
@@ -2300,23 +2535,37 @@ void TilesFramework::json_write_comma()
     if (m_msg_buf.empty()) return;
     char last = m_msg_buf[m_msg_buf.size() - 1];
     if (last == '{' || last == '[' || last == ',' || last == ':') return;
-    write_message(",");
+    m_msg_buf.push_back(',');
 }
 
 void TilesFramework::json_write_name(const string& name)
 {
     json_write_comma();
 
-    write_message("\"");
+    m_msg_buf.push_back('"');
     write_message_escaped(name);
-    write_message("\":");
+    m_msg_buf.append("\":", 2);
 }
 
 void TilesFramework::json_write_int(int value)
 {
     json_write_comma();
 
-    write_message("%d", value);
+    // Digits are produced backwards from the end of the buffer.
+    char buf[12];
+    char *const end = buf + sizeof(buf);
+    char *p = end;
+    unsigned int u = value < 0 ? 0U - (unsigned int) value : value;
+    do
+    {
+        *--p = '0' + u % 10;
+        u /= 10;
+    }
+    while (u);
+    if (value < 0)
+        *--p = '-';
+
+    m_msg_buf.append(p, end - p);
 }
 
 void TilesFramework::json_write_int(const string& name, int value)
@@ -2332,9 +2581,9 @@ void TilesFramework::json_write_bool(bool value)
     json_write_comma();
 
     if (value)
-        write_message("true");
+        m_msg_buf.append("true", 4);
     else
-        write_message("false");
+        m_msg_buf.append("false", 5);
 }
 
 void TilesFramework::json_write_bool(const string& name, bool value)
@@ -2349,7 +2598,7 @@ void TilesFramework::json_write_null()
 {
     json_write_comma();
 
-    write_message("null");
+    m_msg_buf.append("null", 4);
 }
 
 void TilesFramework::json_write_null(const string& name)
@@ -2364,9 +2613,9 @@ void TilesFramework::json_write_string(const string& value)
 {
     json_write_comma();
 
-    write_message("\"");
+    m_msg_buf.push_back('"');
     write_message_escaped(value);
-    write_message("\"");
+    m_msg_buf.push_back('"');
 }
 
 void TilesFramework::json_write_string(const string& name, const string& value)
@@ -8,6 +8,8 @@
 #ifdef USE_TILE_WEB
 
 #include <bitset>
+#include <cstdarg>
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -21,6 +23,7 @@
 #include "text-tag-type.h"
 #include "tiledoll.h"
 #include "tilemcache.h"
+#include "tileweb-ring.h"
 #include "tileweb-text.h"
 #include "viewgeom.h"
 
@@ -199,6 +202,7 @@ public:
     bool json_is_empty();
 
     string m_sock_name;
+    string m_ring_name;
     bool m_await_connection;
 
     void set_text_cursor(bool enabled);
@@ -222,12 +226,37 @@ protected:
     string m_msg_buf;
     vector<sockaddr_un> m_dest_addrs;
 
+    // Optional shared-memory transport to the primary server connection.
+    // Messages that do not fit yet wait in m_ring_backlog; the datagram
+    // path is still used for every other destination.
+    webtiles_ring m_ring;
+    bool m_ring_attached;
+    sockaddr_un m_ring_dest;
+    deque<string> m_ring_backlog;
+    size_t m_ring_backlog_size;
+
     bool m_controlled_from_web;
     bool m_need_flush;
 
     bool _send_lock; // not thread safe
 
+    // What _send_everything() last sent ahead of the live state, kept so
+    // that further spectators can be sent the same bytes. It stays valid
+    // until some other message that could change that state goes out;
+    // m_msg_generation counts those.
+    vector<string> m_join_snapshot;
+    unsigned int m_msg_generation;
+    unsigned int m_join_snapshot_generation;
+    bool m_capture_join_snapshot;
+    bool m_snapshot_neutral;
+
     void _await_connection();
+    bool _is_ring_dest(const sockaddr_un &addr) const;
+    void _ring_send(const string &msg);
+    void _ring_drain_backlog();
+    void _ring_wake();
+    void _ring_detach();
+    void _vwrite_message(const char *format, va_list argp);
     wint_t _handle_control_message(sockaddr_un addr, string data);
     wint_t _receive_control_message();
 
@@ -311,6 +340,8 @@ protected:
     void _send_layout();
 
     void _send_everything();
+    void _send_join_snapshot();
+    void _send_input_mode(mouse_mode mode);
 
     bool m_mcache_ref_done;
     void _mcache_ref(bool inc);
@@ -15,6 +15,7 @@
 #include "cloud.h"
 #include "coordit.h"
 #include "corpse.h"
+#include "dactions.h"
 #include "database.h"
 #include "dgn-shoals.h"
 #include "dgn-event.h"
@@ -36,6 +37,7 @@
 #include "mon-project.h"
 #include "mutation.h"
 #include "notes.h"
+#include "options.h"
 #include "player.h"
 #include "player-stats.h"
 #include "random.h"
@@ -820,23 +822,11 @@ void monster::timeout_enchantments(int levels)
     }
 }
 
-/**
- * Update the level upon the player's return.
- *
- * @param elapsedTime how long the player was away.
- */
-void update_level(int elapsedTime)
+// Everything update_level() does besides visiting the monsters.
+static void _update_level_features(int elapsedTime)
 {
-    ASSERT(!crawl_state.game_is_arena());
-
     const int turns = elapsedTime / 10;
 
-#ifdef DEBUG_DIAGNOSTICS
-    int mons_total = 0;
-
-    dprf("turns: %d", turns);
-#endif
-
     rot_corpses(elapsedTime);
     shoals_apply_tides(turns, true);
     timeout_tombs(turns);
@@ -852,6 +842,26 @@ void update_level(int elapsedTime)
 
     dungeon_events.fire_event(
         dgn_event(DET_TURN_ELAPSED, coord_def(0, 0), turns * 10));
+}
+
+/**
+ * Update the level upon the player's return.
+ *
+ * @param elapsedTime how long the player was away.
+ */
+void update_level(int elapsedTime)
+{
+    ASSERT(!crawl_state.game_is_arena());
+
+    const int turns = elapsedTime / 10;
+
+#ifdef DEBUG_DIAGNOSTICS
+    int mons_total = 0;
+
+    dprf("turns: %d", turns);
+#endif
+
+    _update_level_features(elapsedTime);
 
     for (monster_iterator mi; mi; ++mi)
     {
@@ -870,6 +880,71 @@ void update_level(int elapsedTime)
     delete_all_clouds();
 }
 
+/**
+ * Bring a level that is being loaded up to date: the time that passed while
+ * the player was away (if elapsedTime is nonzero), and then any delayed
+ * actions queued since the last visit.
+ *
+ * Done separately, each of those is a pass over every monster on the level.
+ * Here the monster updates and the run of per-monster delayed actions that
+ * follows them share a single pass; each monster still sees the same steps
+ * in the same order. Only the order across monsters changes, and with it
+ * the order in which they draw random numbers, so legacy_level_catchup
+ * keeps the old passes for anyone who needs a seeded game to play out
+ * exactly as it did before.
+ *
+ * @param elapsedTime how long the player was away, or 0 to only apply
+ *                    delayed actions.
+ */
+void catchup_level(int elapsedTime)
+{
+    ASSERT(!crawl_state.game_is_arena());
+
+    if (Options.legacy_level_catchup)
+    {
+        if (elapsedTime)
+            update_level(elapsedTime);
+        catchup_dactions();
+        return;
+    }
+
+    const int turns = elapsedTime / 10;
+
+    if (elapsedTime)
+        _update_level_features(elapsedTime);
+
+    vector<daction_type> mons_acts;
+    while (env.dactions_done < you.dactions.size()
+           && daction_is_per_monster(you.dactions[env.dactions_done]))
+    {
+        mons_acts.push_back(you.dactions[env.dactions_done++]);
+    }
+
+    if (elapsedTime || !mons_acts.empty())
+    {
+        for (monster_iterator mi; mi; ++mi)
+        {
+            if (elapsedTime && !update_monster(**mi, turns))
+                continue;
+
+            for (daction_type act : mons_acts)
+            {
+                if (!mi->alive())
+                    break;
+                if (mons_matches_daction(*mi, act))
+                    apply_daction_to_mons(*mi, act, true, false);
+            }
+        }
+    }
+
+    if (elapsedTime)
+        delete_all_clouds();
+
+    // Whatever is left starts with an action that isn't a plain monster
+    // pass, so it goes through in order.
+    catchup_dactions();
+}
+
 /**
  * Update the monster upon the player's return
  *
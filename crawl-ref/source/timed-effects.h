@@ -6,6 +6,7 @@
 #pragma once
 
 void update_level(int elapsedTime);
+void catchup_level(int elapsedTime);
 monster* update_monster(monster& mon, int turns);
 void handle_time();
 
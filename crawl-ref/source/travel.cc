@@ -4463,8 +4463,11 @@ bool runrest::diag_run_passes_door() const
 
 void runrest::stop(bool clear_delays)
 {
+    // Also redraw if an undelayed run left the view out of date; the caller
+    // may be about to wait for input without drawing it again.
     bool need_redraw =
-        (runmode > 0 || runmode < 0 && Options.travel_delay == -1);
+        (runmode > 0 || runmode < 0 && Options.travel_delay == -1)
+        || view_frame_skipped();
     _userdef_run_stoprunning_hook();
     runmode = RMODE_NOT_RUNNING;
 
@@ -13,6 +13,7 @@
 #include "ui.h"
 #include "cio.h"
 #include "macro.h"
+#include "replay.h"
 #include "state.h"
 #include "tileweb.h"
 #include "unicode.h"
@@ -3375,6 +3376,10 @@ int getch(KeymapContext km)
 
 void delay(unsigned int ms)
 {
+    // Headless modes have no screen to show and no keys to pump.
+    if (!crawl_state.io_inited)
+        return;
+
     if (crawl_state.disables[DIS_DELAY])
         ms = 0;
 
@@ -3392,6 +3397,14 @@ void delay(unsigned int ms)
     }
     while ((unsigned)wait_event_timeout < ms && !crawl_state.seen_hups);
 #else
+    replay_timed_wait wait;
+    if (replay_playing())
+    {
+        while (wait.key_due() && !crawl_state.seen_hups)
+            pump_events();
+        return;
+    }
+
     constexpr int poll_interval = 10;
     while (!crawl_state.seen_hups)
     {
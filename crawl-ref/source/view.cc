@@ -8,6 +8,7 @@
 #include "view.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <memory>
@@ -57,6 +58,7 @@
 #include "player.h"
 #include "random.h"
 #include "religion.h"
+#include "replay.h"
 #include "shout.h"
 #include "show.h"
 #include "showsymb.h"
@@ -1328,17 +1330,83 @@ static bool _view_is_updating = false;
 
 crawl_view_buffer view_dungeon(animation *a, bool anim_updates, view_renderer *renderer);
 
+/// The per-move delay the current run, rest or explore is using.
+static int _runrest_delay()
+{
+    if (you.running.is_rest())
+        return Options.rest_delay;
+    if (you.running.is_explore() && Options.explore_delay >= 0)
+        return Options.explore_delay;
+    return Options.travel_delay;
+}
+
+/// A cheap summary of what is in view that the player needs to see drawn.
+static uint32_t _runrest_view_signature()
+{
+    uint32_t sig = 2166136261U;
+    for (monster_near_iterator mi(&you); mi; ++mi)
+        if (you.can_see(**mi))
+            sig = (sig ^ mi->mid) * 16777619U;
+    return sig;
+}
+
+// Whether the last frame viewwindow() was asked for was skipped by
+// _runrest_frame_due(), so that what is on screen is out of date.
+static bool runrest_frame_skipped = false;
+
+/**
+ * With no delay between moves the frames in the middle of a run are never
+ * actually seen, so only draw one when the monsters in view change, when
+ * something wants to flash the screen, or when runrest_redraw_interval has
+ * passed. Whatever state the run stops in is drawn by the first viewwindow()
+ * call after you.running is cleared.
+ */
+static bool _runrest_frame_due()
+{
+    static uint32_t last_sig = 0;
+    static chrono::steady_clock::time_point last_frame;
+
+    const uint32_t sig = _runrest_view_signature();
+    const auto now = chrono::steady_clock::now();
+    if (sig == last_sig && you.flash_colour == BLACK
+        && now - last_frame
+           < chrono::milliseconds(Options.runrest_redraw_interval))
+    {
+        runrest_frame_skipped = true;
+        return false;
+    }
+
+    last_sig = sig;
+    last_frame = now;
+    return true;
+}
+
+/// Has a frame been skipped during undelayed run or rest since the view was
+/// last drawn?
+bool view_frame_skipped()
+{
+    return runrest_frame_skipped;
+}
+
 static bool _viewwindow_should_render()
 {
+    // Nothing to draw on, e.g. in headless arena tournaments, or nobody to
+    // see it.
+    if (!crawl_state.io_inited || replay_headless())
+        return false;
     if (you.asleep())
         return false;
     if (mouse_control::current_mode() != MOUSE_MODE_NORMAL)
         return true;
-    if (you.running && you.running.is_rest())
-        return Options.rest_delay != -1;
-    const bool run_dont_draw = you.running && Options.travel_delay < 0
-                && (!you.running.is_explore() || Options.explore_delay < 0);
-    return !run_dont_draw;
+    if (!you.running)
+        return true;
+
+    const int delay = _runrest_delay();
+    if (delay < 0)
+        return false;
+    if (delay > 0 || !Options.runrest_redraw_interval)
+        return true;
+    return _runrest_frame_due();
 }
 
 /**
@@ -1424,6 +1492,7 @@ void viewwindow(bool show_updates, bool tiles_only, animation *a, view_renderer
 
         if (_viewwindow_should_render())
         {
+            runrest_frame_skipped = false;
             const auto vbuf = view_dungeon(a, anim_updates, renderer);
 
             you.last_view_update = you.num_turns;
@@ -28,6 +28,7 @@ string screenshot();
 
 int viewmap_flash_colour();
 bool view_update();
+bool view_frame_skipped();
 void view_update_at(const coord_def &pos);
 class targeter;
 
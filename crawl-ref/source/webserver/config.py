@@ -54,6 +54,12 @@ template_path = "./webserver/templates/"
 # Path for server-side unix sockets (to be used to communicate with crawl)
 server_socket_path = None # Uses global temp dir
 
+# Have crawl send game messages through a shared-memory ring (in /dev/shm
+# where available) instead of one datagram per fragment. Crawl never waits
+# for a slow server on this path; the socket is still used for wakeups and
+# for everything sent to crawl.
+use_shm_transport = False
+
 # Server name, so far only used in the ttyrec metadata
 server_id = ""
 
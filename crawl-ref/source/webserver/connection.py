@@ -12,13 +12,16 @@ from tornado.escape import json_encode
 from tornado.escape import to_unicode
 from tornado.escape import utf8
 from tornado.ioloop import IOLoop
+from tornado.ioloop import PeriodicCallback
 
 from config import server_socket_path
+from shm_ring import RingReader
 
 
 class WebtilesSocketConnection(object):
-    def __init__(self, socketpath, logger):
+    def __init__(self, socketpath, logger, ringpath = None):
         self.crawl_socketpath = socketpath
+        self.crawl_ringpath = ringpath
         self.logger = logger
         self.message_callback = None
         self.socket = None
@@ -28,6 +31,9 @@ class WebtilesSocketConnection(object):
 
         self.msg_buffer = None
 
+        self.ring = None
+        self.ring_poll = None
+
     def connect(self, primary = True):
         if not os.path.exists(self.crawl_socketpath):
             # Wait until the socket exists
@@ -69,20 +75,53 @@ class WebtilesSocketConnection(object):
                                      self._handle_read,
                                      IOLoop.ERROR | IOLoop.READ)
 
-        msg = json_encode({
-                "msg": "attach",
-                "primary": primary
-                })
+        attach = {
+            "msg": "attach",
+            "primary": primary
+            }
+        if primary and self.crawl_ringpath:
+            self._open_ring()
+            if self.ring:
+                attach["shm"] = True
+        msg = json_encode(attach)
 
         self.open = True
 
         self.send_message(utf8(msg))
 
+    def _open_ring(self):
+        try:
+            self.ring = RingReader(self.crawl_ringpath)
+        except (OSError, IOError, ValueError):
+            self.logger.warning("Can't open game ring %s, using the socket.",
+                                self.crawl_ringpath, exc_info=True)
+            return
+        self.ring.set_waiting()
+        # Wakeups can in principle be lost, since Python can't fence the
+        # waiting flag against our read of the head; polling bounds the delay.
+        self.ring_poll = PeriodicCallback(self._drain_ring, 50)
+        self.ring_poll.start()
+
+    def _drain_ring(self):
+        while self.ring:
+            data = self.ring.pop()
+            if data is None:
+                # Announce we're going to sleep, then check once more so a
+                # record written just before the flag was set isn't missed.
+                self.ring.set_waiting()
+                data = self.ring.pop()
+                if data is None:
+                    return
+            self._handle_data(data)
+
     def _handle_read(self, fd, events):
         if events & IOLoop.READ:
             data = self.socket.recv(128 * 1024, socket.MSG_DONTWAIT)
 
-            self._handle_data(data)
+            # Empty datagrams are ring wakeups.
+            if data:
+                self._handle_data(data)
+            self._drain_ring()
 
         if events & IOLoop.ERROR:
             pass
@@ -116,6 +155,12 @@ class WebtilesSocketConnection(object):
             self.logger.warning("Slow socket send: " + str(end - start))
 
     def close(self):
+        if self.ring_poll:
+            self.ring_poll.stop()
+            self.ring_poll = None
+        if self.ring:
+            self.ring.close()
+            self.ring = None
         if self.socket:
             IOLoop.current().remove_handler(self.socket.fileno())
             self.socket.close()
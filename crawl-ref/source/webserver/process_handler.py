@@ -604,6 +604,7 @@ class CrawlProcessHandler(CrawlProcessHandlerBase):
     def __init__(self, game_params, username, logger):
         super(CrawlProcessHandler, self).__init__(game_params, username, logger)
         self.socketpath = None
+        self.ringpath = None
         self.conn = None
         self.ttyrec_filename = None
         self.inprogress_lock = None
@@ -759,6 +760,15 @@ class CrawlProcessHandler(CrawlProcessHandlerBase):
         call = self._base_call() + ["-webtiles-socket", self.socketpath,
                                     "-await-connection"]
 
+        self.ringpath = None
+        if getattr(config, "use_shm_transport", False):
+            ring_dir = "/dev/shm" if os.path.isdir("/dev/shm") \
+                       else self.config_path("socket_path")
+            self.ringpath = os.path.join(ring_dir,
+                                         os.path.basename(self.socketpath)
+                                         + ".ring")
+            call += ["-webtiles-shm", self.ringpath]
+
         ttyrec_path = self.config_path("ttyrec_path")
         if ttyrec_path:
             self.ttyrec_filename = os.path.join(ttyrec_path, self.lock_basename)
@@ -802,7 +812,8 @@ class CrawlProcessHandler(CrawlProcessHandlerBase):
 
     def connect(self, socketpath, primary = False):
         self.socketpath = socketpath
-        self.conn = WebtilesSocketConnection(self.socketpath, self.logger)
+        self.conn = WebtilesSocketConnection(self.socketpath, self.logger,
+                                             self.ringpath)
         self.conn.message_callback = self._on_socket_message
         self.conn.close_callback = self._on_socket_close
         self.conn.connect(primary)
@@ -817,6 +828,17 @@ class CrawlProcessHandler(CrawlProcessHandlerBase):
         f.write("%s\n%s\n%s\n" % (self.process.pid, lines, cols))
         f.flush()
 
+    def remove_ring(self):
+        # Crawl unlinks its ring once we've mapped it, and on a clean exit;
+        # this catches a crash before either.
+        if self.ringpath:
+            try:
+                os.unlink(self.ringpath)
+            except OSError as e:
+                if e.errno != errno.ENOENT:
+                    self.logger.warning("Can't remove game ring %s: %s",
+                                        self.ringpath, e)
+
     def remove_inprogress_lock(self):
         if self.inprogress_lock_file is None: return
         fcntl.lockf(self.inprogress_lock_file.fileno(), fcntl.LOCK_UN)
@@ -844,6 +866,7 @@ class CrawlProcessHandler(CrawlProcessHandlerBase):
         self.logger.debug("Crawl PID %s terminated.", self.process.pid)
 
         self.remove_inprogress_lock()
+        self.remove_ring()
 
         try:
             del processes[os.path.abspath(self.socketpath)]
@@ -0,0 +1,78 @@
+"""Reader for crawl's shared-memory message ring (see tileweb-ring.h).
+
+Crawl is the only writer. The server reads complete records out of the
+ring and acknowledges them by advancing the tail; before it goes back to
+sleep on the game socket it sets the waiting flag, and crawl sends an empty
+datagram on the socket only when it finds that flag set.
+"""
+
+import mmap
+import os
+import struct
+
+MAGIC = b"DCSSRING"
+VERSION = 1
+
+HEADER_SIZE = 256
+CAPACITY_OFFSET = 16
+HEAD_OFFSET = 64
+TAIL_OFFSET = 128
+WAITING_OFFSET = 192
+
+_U32 = struct.Struct("=I")
+_U64 = struct.Struct("=Q")
+
+
+class RingReader(object):
+    def __init__(self, path):
+        fd = os.open(path, os.O_RDWR)
+        try:
+            size = os.fstat(fd).st_size
+            if size <= HEADER_SIZE:
+                raise ValueError("ring file too small: %s" % path)
+            self.map = mmap.mmap(fd, size)
+        finally:
+            os.close(fd)
+
+        version = _U32.unpack_from(self.map, 8)[0]
+        self.capacity = _U64.unpack_from(self.map, CAPACITY_OFFSET)[0]
+        if (self.map[0:8] != MAGIC or version != VERSION
+                or self.capacity != size - HEADER_SIZE):
+            self.map.close()
+            raise ValueError("not a crawl message ring: %s" % path)
+
+    def _load(self, offset):
+        # Python gives us no atomic loads; re-read until we get a stable
+        # value so a torn read of the counter can't be mistaken for data.
+        value = _U64.unpack_from(self.map, offset)[0]
+        while True:
+            again = _U64.unpack_from(self.map, offset)[0]
+            if again == value:
+                return value
+            value = again
+
+    def _read(self, pos, length):
+        off = HEADER_SIZE + pos % self.capacity
+        first = min(length, HEADER_SIZE + self.capacity - off)
+        data = self.map[off:off + first]
+        if first < length:
+            data += self.map[HEADER_SIZE:HEADER_SIZE + length - first]
+        return data
+
+    def pop(self):  # type: () -> bytes
+        """Return the oldest record, or None if the ring is empty."""
+        tail = _U64.unpack_from(self.map, TAIL_OFFSET)[0]
+        if self._load(HEAD_OFFSET) == tail:
+            return None
+        length = _U32.unpack(self._read(tail, _U32.size))[0]
+        data = self._read(tail + _U32.size, length)
+        _U64.pack_into(self.map, TAIL_OFFSET, tail + _U32.size + length)
+        return data
+
+    def set_waiting(self):
+        _U32.pack_into(self.map, WAITING_OFFSET, 1)
+
+    def close(self):
+        if self.map:
+            self.map.close()
+            self.map = None
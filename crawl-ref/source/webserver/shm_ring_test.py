@@ -0,0 +1,61 @@
+import struct
+
+import pytest
+
+import shm_ring
+
+
+def make_ring(path, capacity, records):
+    """A stand-in for crawl's side of the ring: write records into a file."""
+    data = bytearray(capacity)
+    head = 0
+    for record in records:
+        for byte in bytearray(struct.pack("=I", len(record)) + record):
+            data[head % capacity] = byte
+            head += 1
+    header = bytearray(shm_ring.HEADER_SIZE)
+    header[0:8] = shm_ring.MAGIC
+    struct.pack_into("=I", header, 8, shm_ring.VERSION)
+    struct.pack_into("=Q", header, shm_ring.CAPACITY_OFFSET, capacity)
+    struct.pack_into("=Q", header, shm_ring.HEAD_OFFSET, head)
+    with open(path, "wb") as f:
+        f.write(bytes(header + data))
+
+
+class Test_RingReader:
+    def test_pop_returns_records_in_order(self, tmpdir):
+        path = str(tmpdir.join("game.ring"))
+        make_ring(path, 4096, [b'{"msg":"one"}\n', b"", b"two"])
+        ring = shm_ring.RingReader(path)
+        assert ring.pop() == b'{"msg":"one"}\n'
+        assert ring.pop() == b""
+        assert ring.pop() == b"two"
+        assert ring.pop() is None
+        ring.close()
+
+    def test_pop_handles_wraparound(self, tmpdir):
+        path = str(tmpdir.join("game.ring"))
+        records = [b"a" * 3000, b"b" * 3000]
+        # The second record wraps; pretend the first was already read.
+        make_ring(path, 4096, records)
+        ring = shm_ring.RingReader(path)
+        struct.pack_into("=Q", ring.map, shm_ring.TAIL_OFFSET, 3004)
+        assert ring.pop() == records[1]
+        assert ring.pop() is None
+        ring.close()
+
+    def test_set_waiting(self, tmpdir):
+        path = str(tmpdir.join("game.ring"))
+        make_ring(path, 4096, [])
+        ring = shm_ring.RingReader(path)
+        ring.set_waiting()
+        assert struct.unpack_from("=I", ring.map,
+                                  shm_ring.WAITING_OFFSET)[0] == 1
+        ring.close()
+
+    def test_rejects_other_files(self, tmpdir):
+        path = str(tmpdir.join("junk"))
+        with open(path, "wb") as f:
+            f.write(b"\0" * 8192)
+        with pytest.raises(ValueError):
+            shm_ring.RingReader(path)
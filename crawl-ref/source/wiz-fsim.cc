@@ -8,12 +8,15 @@
 #include "wiz-fsim.h"
 
 #include <cerrno>
+#include <chrono>
 
 #include "beam.h"
 #include "bitary.h"
 #include "coordit.h"
 #include "dbg-util.h"
 #include "directn.h"
+#include "dungeon.h"
+#include "end.h"
 #include "env.h"
 #include "fight.h"
 #include "item-prop.h"
@@ -21,6 +24,7 @@
 #include "item-use.h"
 #include "jobs.h"
 #include "libutil.h"
+#include "los.h"
 #include "makeitem.h"
 #include "message.h"
 #include "mgen-data.h"
@@ -29,6 +33,9 @@
 #include "mon-place.h"
 #include "monster.h"
 #include "mon-util.h"
+#include "newgame.h"
+#include "newgame-def.h"
+#include "ng-setup.h"
 #include "options.h"
 #include "output.h"
 #include "player-equip.h"
@@ -38,7 +45,9 @@
 #include "species.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "throw.h"
+#include "unicode.h"
 #include "unwind.h"
 #include "version.h"
 #include "wiz-you.h"
@@ -259,8 +268,11 @@ static bool _fsim_kit_equip(const string &kit, string &error)
         }
     }
 
-    redraw_screen();
-    update_screen();
+    if (crawl_state.fsim_batch.empty())
+    {
+        redraw_screen();
+        update_screen();
+    }
     return true;
 }
 
@@ -339,8 +351,11 @@ static monster* _init_fsim()
     mon->hit_points = mon->max_hit_points = MAX_MONSTER_HP;
     mon->behaviour = BEH_SEEK;
 
-    redraw_screen();
-    update_screen();
+    if (crawl_state.fsim_batch.empty())
+    {
+        redraw_screen();
+        update_screen();
+    }
 
     return mon;
 }
@@ -793,4 +808,228 @@ void wizard_fight_sim(bool double_scale)
     mpr("Done.");
 }
 
+// Headless batch mode (-fsim <matrix>): see docs/fight_simulator.txt.
+
+struct fsim_matchup
+{
+    string combo;
+    string kit;
+    string skills;
+    string monster;
+    bool defend;
+};
+
+static vector<fsim_matchup> _read_fsim_matrix(const string &filename)
+{
+    FileLineInput f(filename.c_str());
+    if (f.error())
+    {
+        end(1, false, "Can't read fsim matrix %s: %s", filename.c_str(),
+            strerror(errno));
+    }
+
+    vector<fsim_matchup> matchups;
+    int lineno = 0;
+    while (!f.eof())
+    {
+        ++lineno;
+        const string line = trimmed_string(f.get_line());
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        const vector<string> fields = split_string("|", line, true, true);
+        if (fields.size() < 4 || fields.size() > 5)
+        {
+            end(1, false, "%s:%d: expected 4 or 5 fields separated by |",
+                filename.c_str(), lineno);
+        }
+
+        fsim_matchup m;
+        m.combo = fields[0];
+        m.kit = fields[1];
+        m.skills = fields[2];
+        const string mode = fields.size() > 4 ? fields[4] : Options.fsim_mode;
+        m.defend = mode.find("defen") != string::npos;
+
+        if (m.combo.size() != 4
+            || species::from_abbrev(m.combo.substr(0, 2).c_str()) == SP_UNKNOWN
+            || get_job_by_abbrev(m.combo.substr(2, 2).c_str()) == JOB_UNKNOWN)
+        {
+            end(1, false, "%s:%d: unknown combo '%s'", filename.c_str(),
+                lineno, m.combo.c_str());
+        }
+
+        for (const string &mons : split_string(",", fields[3]))
+        {
+            if (get_monster_by_name(mons, true) == MONS_PROGRAM_BUG)
+            {
+                end(1, false, "%s:%d: unknown monster '%s'", filename.c_str(),
+                    lineno, mons.c_str());
+            }
+            m.monster = mons;
+            matchups.push_back(m);
+        }
+    }
+    return matchups;
+}
+
+// A 3x3 room in solid rock, so nothing but the matchup can get involved.
+static void _fsim_batch_level()
+{
+    dgn_reset_level();
+    env.grid.init(DNGN_ROCK_WALL);
+    const coord_def centre(GXM / 2, GYM / 2);
+    for (radius_iterator ri(centre, 1, C_SQUARE); ri; ++ri)
+        env.grid(*ri) = DNGN_FLOOR;
+    env.map_knowledge.init(map_cell());
+    you.moveto(centre);
+    los_changed();
+}
+
+static bool _fsim_batch_skills(const string &spec, string &error)
+{
+    for (const string &entry : split_string(",", spec))
+    {
+        string::size_type sep = entry.find_last_of(" :");
+        if (sep == string::npos)
+        {
+            error = "no level given for '" + entry + "'";
+            return false;
+        }
+        string name = lowercase_string(entry.substr(0, sep));
+        trim_string(name);
+        const int level = atoi(entry.substr(sep + 1).c_str());
+
+        if (name == "xl")
+        {
+            set_xl(max(1, min(level, 27)), false);
+            continue;
+        }
+
+        const skill_type sk = name == "weapon" ? _equipped_skill()
+                                               : skill_from_name(name.c_str());
+        if (sk == SK_NONE)
+        {
+            error = "unknown skill '" + name + "'";
+            return false;
+        }
+        set_skill_level(sk, max(0, min(level, 27)));
+    }
+    return true;
+}
+
+static string _fsim_batch_run_one(const fsim_matchup &m, uint64_t seed)
+{
+    const string prefix = make_stringf("%s\t%s\t%s\t%s\t%s\t%" PRIu64 "\t",
+                                       m.combo.c_str(), m.kit.c_str(),
+                                       m.skills.c_str(), m.monster.c_str(),
+                                       m.defend ? "defense" : "attack",
+                                       seed);
+    msg::suppress mx;
+
+    if (you.save)
+    {
+        you.save->abort();
+        delete you.save;
+        you.save = nullptr;
+    }
+
+    newgame_def ng;
+    ng.name = "fsim";
+    ng.type = GAME_TYPE_CUSTOM_SEED;
+    ng.species = species::from_abbrev(m.combo.substr(0, 2).c_str());
+    ng.job = get_job_by_abbrev(m.combo.substr(2, 2).c_str());
+    // An empty kit keeps the starting equipment, so pick the weapon the
+    // background would start with.
+    ng.weapon = default_starting_weapon(ng);
+    Options.seed = seed;
+    setup_game(ng, false);
+    _fsim_batch_level();
+
+    string error;
+    if ((!m.kit.empty() && !_fsim_kit_equip(m.kit, error))
+        || !_fsim_batch_skills(m.skills, error))
+    {
+        return prefix + "error: " + (error.empty() ? "bad kit" : error) + "\n";
+    }
+
+    Options.fsim_mons = m.monster;
+    monster *mon = _init_fsim();
+    if (!mon)
+        return prefix + "error: could not place monster\n";
+
+    fight_data fdata = _get_fight_data(*mon, Options.fsim_rounds, m.defend);
+    _uninit_fsim(mon);
+    return fdata.summary(prefix, true) + "\n";
+}
+
+// Run every workers'th matchup, starting with the first'th, into o. Each
+// line is tagged with its matchup index so the results can be merged.
+static void _fsim_batch_worker(const vector<fsim_matchup> &matchups,
+                               uint64_t base_seed, int first, int workers,
+                               FILE *o)
+{
+    for (size_t i = first; i < matchups.size(); i += workers)
+    {
+        const string rows = _fsim_batch_run_one(matchups[i], base_seed + i);
+        for (const string &row : split_string("\n", rows, false, false))
+            fprintf(o, "%u\t%s\n", (unsigned int) i, row.c_str());
+        fflush(o);
+    }
+}
+
+/**
+ * Run a matrix of fight simulations without a game or a screen, spread over
+ * forked worker processes (one per CPU if workers is 0), and write the
+ * results to fsim-batch.tsv.
+ *
+ * Every matchup gets its own seed (base seed + matchup index), so results
+ * do not depend on how many workers were used; pass -seed to repeat a run.
+ */
+void fsim_batch(const string &matrix, int workers)
+{
+    const vector<fsim_matchup> matchups = _read_fsim_matrix(matrix);
+    if (matchups.empty())
+        end(1, false, "No matchups in %s", matrix.c_str());
+
+    Options.no_save = true;
+    const uint64_t base_seed = Options.seed ? Options.seed : rng::get_uint64();
+    const auto start = chrono::steady_clock::now();
+    const vector<vector<string>> rows = run_worker_pool(workers,
+        matchups.size(), "fsim-batch",
+        [&](int first, int step, FILE *o)
+        {
+            _fsim_batch_worker(matchups, base_seed, first, step, o);
+        });
+    const double secs = chrono::duration<double>(chrono::steady_clock::now()
+                                                 - start).count();
+
+    const char *outfile = "fsim-batch.tsv";
+    FILE *o = fopen_u(outfile, "w");
+    if (!o)
+        end(1, true, "Can't write %s", outfile);
+    fprintf(o, "Combo\tKit\tSkills\tMonster\tMode\tSeed\t%s\n",
+            fight_data::header(true).c_str());
+    // Only matchups that actually fought count towards the throughput; one
+    // that couldn't be set up still leaves an error row in the results.
+    int done = 0;
+    for (const auto &matchup_rows : rows)
+    {
+        bool failed = matchup_rows.empty();
+        for (const string &row : matchup_rows)
+        {
+            failed |= row.find("\terror: ") != string::npos;
+            fprintf(o, "%s\n", row.c_str());
+        }
+        done += !failed;
+    }
+    fclose(o);
+
+    const double rounds = double(done) * Options.fsim_rounds;
+    printf("fsim: %d/%u matchups, %.0f rounds in %.1fs on %d workers"
+           " (%.0f rounds/second); results in %s\n",
+           done, (unsigned int) matchups.size(), rounds, secs, workers,
+           secs > 0 ? rounds / secs : 0.0, outfile);
+}
+
 #endif